@@ -64,6 +64,8 @@ namespace Plugin {
                 _controller->Register(&_dialogueNotification);
                 Exchange::JAVSController::Register(*this, _controller);
             }
+            RegisterDiagnostics();
+            RegisterKeywordDetection();
         }
 
         if (message.empty() == true) {
@@ -81,6 +83,9 @@ namespace Plugin {
         if (_AVSClient != nullptr) {
             TRACE_L1(_T("Deinitializing AVSClient..."));
 
+            UnregisterKeywordDetection();
+            UnregisterDiagnostics();
+
             if (_controller != nullptr) {
                 _controller->Unregister(&_dialogueNotification);
                 _controller->Release();
@@ -117,6 +122,261 @@ namespace Plugin {
         }
     }
 
+    void AVS::RegisterDiagnostics()
+    {
+        ASSERT(_AVSClient != nullptr);
+
+        _diagnostics = _AVSClient->QueryInterface<IAVSDiagnostics>();
+        if (_diagnostics != nullptr) {
+            Property<Diagnostics::VoiceStatistics>(_T("voicestatistics"), &AVS::get_voicestatistics, nullptr, this);
+            Property<Diagnostics::MemoryStatistics>(_T("memorystatistics"), &AVS::get_memorystatistics, nullptr, this);
+            Property<Diagnostics::KeywordStatistics>(_T("keywordstatistics"), &AVS::get_keywordstatistics, nullptr, this);
+            Property<Diagnostics::LogStatistics>(_T("logstatistics"), &AVS::get_logstatistics, nullptr, this);
+            Property<Diagnostics::ObserverStatistics>(_T("observerstatistics"), &AVS::get_observerstatistics, nullptr, this);
+            Register<void, Core::JSON::String>(_T("dumplog"), &AVS::endpoint_dumplog, this);
+            Property<Core::JSON::String>(_T("loglevel"), &AVS::get_loglevel, &AVS::set_loglevel, this);
+        } else {
+            TRACE_L1(_T("AVSClient diagnostics are not reachable from this process"));
+        }
+    }
+
+    void AVS::UnregisterDiagnostics()
+    {
+        if (_diagnostics != nullptr) {
+            Unregister(_T("voicestatistics"));
+            Unregister(_T("memorystatistics"));
+            Unregister(_T("keywordstatistics"));
+            Unregister(_T("logstatistics"));
+            Unregister(_T("observerstatistics"));
+            Unregister(_T("dumplog"));
+            Unregister(_T("loglevel"));
+            _diagnostics->Release();
+            _diagnostics = nullptr;
+        }
+    }
+
+    void AVS::RegisterKeywordDetection()
+    {
+        ASSERT(_AVSClient != nullptr);
+
+        _keywordDetection = _AVSClient->QueryInterface<IAVSKeywordDetection>();
+        if (_keywordDetection != nullptr) {
+            Property<Core::JSON::String>(_T("locale"), &AVS::get_locale, &AVS::set_locale, this);
+            Property<Core::JSON::String>(_T("keyword"), &AVS::get_keyword, &AVS::set_keyword, this);
+            Property<Core::JSON::DecUInt32>(_T("threshold"), &AVS::get_threshold, &AVS::set_threshold, this);
+            _keywordDetection->Register(&_keywordNotification);
+        }
+    }
+
+    void AVS::UnregisterKeywordDetection()
+    {
+        if (_keywordDetection != nullptr) {
+            _keywordDetection->Unregister(&_keywordNotification);
+            Unregister(_T("locale"));
+            Unregister(_T("keyword"));
+            Unregister(_T("threshold"));
+            _keywordDetection->Release();
+            _keywordDetection = nullptr;
+        }
+    }
+
+    uint32_t AVS::get_voicestatistics(Diagnostics::VoiceStatistics& response) const
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string statistics;
+        uint32_t result = _diagnostics->VoiceStatistics(statistics);
+        if (result == Core::ERROR_NONE) {
+            response.FromString(statistics);
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::get_memorystatistics(Diagnostics::MemoryStatistics& response) const
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string statistics;
+        uint32_t result = _diagnostics->MemoryStatistics(statistics);
+        if (result == Core::ERROR_NONE) {
+            response.FromString(statistics);
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::get_keywordstatistics(Diagnostics::KeywordStatistics& response) const
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string statistics;
+        uint32_t result = _diagnostics->KeywordStatistics(statistics);
+        if (result == Core::ERROR_NONE) {
+            response.FromString(statistics);
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::get_logstatistics(Diagnostics::LogStatistics& response) const
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string statistics;
+        uint32_t result = _diagnostics->LogStatistics(statistics);
+        if (result == Core::ERROR_NONE) {
+            response.FromString(statistics);
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::get_observerstatistics(Diagnostics::ObserverStatistics& response) const
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string statistics;
+        uint32_t result = _diagnostics->ObserverStatistics(statistics);
+        if (result == Core::ERROR_NONE) {
+            response.FromString(statistics);
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::endpoint_dumplog(Core::JSON::String& response)
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string path;
+        uint32_t result = _diagnostics->DumpLog(path);
+        if (result == Core::ERROR_NONE) {
+            response = path;
+        }
+
+        return result;
+    }
+
+    // The index is the SDK component, without it the general trace level is addressed
+    uint32_t AVS::get_loglevel(const string& index, Core::JSON::String& response) const
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        string level;
+        uint32_t result = _diagnostics->LogLevel(index, level);
+        if (result == Core::ERROR_NONE) {
+            response = level;
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::set_loglevel(const string& index, const Core::JSON::String& param)
+    {
+        ASSERT(_diagnostics != nullptr);
+
+        uint32_t result = Core::ERROR_BAD_REQUEST;
+        if (param.IsSet() == true) {
+            result = _diagnostics->SetLogLevel(index, param.Value());
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::get_locale(Core::JSON::String& response) const
+    {
+        ASSERT(_keywordDetection != nullptr);
+
+        string locale;
+        uint32_t result = _keywordDetection->Locale(locale);
+        if (result == Core::ERROR_NONE) {
+            response = locale;
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::set_locale(const Core::JSON::String& param)
+    {
+        ASSERT(_keywordDetection != nullptr);
+
+        uint32_t result = Core::ERROR_BAD_REQUEST;
+        if ((param.IsSet() == true) && (param.Value().empty() == false)) {
+            result = _keywordDetection->SetLocale(param.Value());
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::get_keyword(Core::JSON::String& response) const
+    {
+        ASSERT(_keywordDetection != nullptr);
+
+        string keyword;
+        uint32_t result = _keywordDetection->Keyword(keyword);
+        if (result == Core::ERROR_NONE) {
+            response = keyword;
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::set_keyword(const Core::JSON::String& param)
+    {
+        ASSERT(_keywordDetection != nullptr);
+
+        uint32_t result = Core::ERROR_BAD_REQUEST;
+        if ((param.IsSet() == true) && (param.Value().empty() == false)) {
+            result = _keywordDetection->SetKeyword(param.Value());
+        }
+
+        return result;
+    }
+
+    // The index is the keyword, without it the keyword currently detected is addressed
+    uint32_t AVS::get_threshold(const string& index, Core::JSON::DecUInt32& response) const
+    {
+        ASSERT(_keywordDetection != nullptr);
+
+        uint32_t threshold = 0;
+        uint32_t result = _keywordDetection->Threshold(index, threshold);
+        if (result == Core::ERROR_NONE) {
+            response = threshold;
+        }
+
+        return result;
+    }
+
+    uint32_t AVS::set_threshold(const string& index, const Core::JSON::DecUInt32& param)
+    {
+        ASSERT(_keywordDetection != nullptr);
+
+        uint32_t result = Core::ERROR_BAD_REQUEST;
+        if (param.IsSet() == true) {
+            result = _keywordDetection->SetThreshold(index, param.Value());
+        }
+
+        return result;
+    }
+
+    void AVS::event_voiceactivity(const bool active)
+    {
+        KeywordDetection::VoiceActivityParams params;
+        params.Active = active;
+
+        Notify(_T("voiceactivity"), params);
+    }
+
+    void AVS::event_keyworddetected(const string& keyword, const uint32_t confidence)
+    {
+        KeywordDetection::KeywordDetectedParams params;
+        params.Keyword = keyword;
+        params.Confidence = confidence;
+
+        Notify(_T("keyworddetected"), params);
+    }
+
     const string AVS::CreateInstance(const string& name, const Config& config)
     {
         TRACE_L1(_T("Launching AVSClient - %s..."), name.c_str());
@@ -26,6 +26,11 @@
 
 #include <AVS/SampleApp/SampleApplicationReturnCodes.h>
 
+#include "IAVSDiagnostics.h"
+#include "IAVSKeywordDetection.h"
+#include "HttpDispatcher.h"
+#include "ThreadScheduling.h"
+
 #if defined(ENABLE_SMART_SCREEN_SUPPORT)
 #include "SmartScreen/SmartScreen.h"
 #endif
@@ -142,6 +147,39 @@ namespace Plugin {
             AVS& _parent;
         };
 
+        class KeywordNotification : public IAVSKeywordDetection::INotification {
+        public:
+            KeywordNotification() = delete;
+            KeywordNotification(const KeywordNotification&) = delete;
+            KeywordNotification& operator=(const KeywordNotification&) = delete;
+
+        public:
+            explicit KeywordNotification(AVS* parent)
+                : _parent(*parent)
+            {
+                ASSERT(parent != nullptr);
+            }
+
+            ~KeywordNotification() = default;
+
+            BEGIN_INTERFACE_MAP(KeywordNotification)
+            INTERFACE_ENTRY(IAVSKeywordDetection::INotification)
+            END_INTERFACE_MAP
+
+        public:
+            void VoiceActivity(const bool active) override
+            {
+                _parent.event_voiceactivity(active);
+            }
+            void KeywordDetected(const string& keyword, const uint32_t confidence) override
+            {
+                _parent.event_keyworddetected(keyword, confidence);
+            }
+
+        private:
+            AVS& _parent;
+        };
+
         class Config : public Core::JSON::Container {
         public:
             Config(const Config&) = delete;
@@ -156,18 +194,54 @@ namespace Plugin {
                 , AlexaClientConfig()
                 , SmartScreenConfig()
                 , LogLevel()
+                , LogLevels()
+                , RecorderLevel(_T("DEBUG0"))
+                , RecorderSize(256)
                 , KWDModelsPath()
+                , KWDEngine()
+                , KWDThresholds()
+                , KWDThread()
+                , KWDCascade()
                 , EnableSmartScreen()
                 , EnableKWD()
+                , VoiceConcealment()
+                , VoiceDecoder()
+                , VoicePreRoll()
+                , VoiceChannel()
+                , VoiceThread()
+                , VTADispatcher()
+                , StreamReaders()
+                , StreamDuration()
+                , StreamWordSize()
+                , StreamLock()
+                , StreamHugePages()
             {
                 Add(_T("audiosource"), &Audiosource);
                 Add(_T("alexaclientconfig"), &AlexaClientConfig);
                 Add(_T("smartscreenconfig"), &SmartScreenConfig);
                 Add(_T("loglevel"), &LogLevel);
+                Add(_T("loglevels"), &LogLevels);
+                Add(_T("recorderlevel"), &RecorderLevel);
+                Add(_T("recordersize"), &RecorderSize);
                 Add(_T("kwdmodelspath"), &KWDModelsPath);
+                Add(_T("kwdengine"), &KWDEngine);
+                Add(_T("kwdthresholds"), &KWDThresholds);
+                Add(_T("kwdthread"), &KWDThread);
+                Add(_T("kwdcascade"), &KWDCascade);
                 Add(_T("enablesmartscreen"), &EnableSmartScreen);
                 Add(_T("enablekwd"), &EnableKWD);
                 Add(_T("outofprocess"), &OutOfProcess);
+                Add(_T("voiceconcealment"), &VoiceConcealment);
+                Add(_T("voicedecoder"), &VoiceDecoder);
+                Add(_T("voicepreroll"), &VoicePreRoll);
+                Add(_T("voicechannel"), &VoiceChannel);
+                Add(_T("voicethread"), &VoiceThread);
+                Add(_T("vtadispatcher"), &VTADispatcher);
+                Add(_T("streamreaders"), &StreamReaders);
+                Add(_T("streamduration"), &StreamDuration);
+                Add(_T("streamwordsize"), &StreamWordSize);
+                Add(_T("streamlock"), &StreamLock);
+                Add(_T("streamhugepages"), &StreamHugePages);
             }
 
             ~Config() = default;
@@ -177,10 +251,28 @@ namespace Plugin {
             Core::JSON::String AlexaClientConfig;
             Core::JSON::String SmartScreenConfig;
             Core::JSON::String LogLevel;
+            Core::JSON::String LogLevels;
+            Core::JSON::String RecorderLevel;
+            Core::JSON::DecUInt32 RecorderSize;
             Core::JSON::String KWDModelsPath;
+            Core::JSON::String KWDEngine;
+            Core::JSON::String KWDThresholds;
+            ThreadSchedulingConfig KWDThread;
+            Core::JSON::Boolean KWDCascade;
             Core::JSON::Boolean EnableSmartScreen;
             Core::JSON::Boolean EnableKWD;
             Core::JSON::Boolean OutOfProcess;
+            Core::JSON::String VoiceConcealment;
+            Core::JSON::String VoiceDecoder;
+            Core::JSON::DecUInt16 VoicePreRoll;
+            Core::JSON::String VoiceChannel;
+            ThreadSchedulingConfig VoiceThread;
+            HttpDispatcherConfig VTADispatcher;
+            Core::JSON::DecUInt8 StreamReaders;
+            Core::JSON::DecUInt16 StreamDuration;
+            Core::JSON::DecUInt8 StreamWordSize;
+            Core::JSON::Boolean StreamLock;
+            Core::JSON::Boolean StreamHugePages;
         };
 
     public:
@@ -189,12 +281,15 @@ namespace Plugin {
         AVS()
             : _AVSClient(nullptr)
             , _controller(nullptr)
+            , _diagnostics(nullptr)
+            , _keywordDetection(nullptr)
             , _service(nullptr)
             , _audiosourceName()
             , _connectionId(0)
             , _audiosourceNotification(this)
             , _connectionNotification(this)
             , _dialogueNotification(this)
+            , _keywordNotification(this)
         {
         }
 
@@ -217,15 +312,42 @@ namespace Plugin {
         void Activated(RPC::IRemoteConnection* connection);
         void Deactivated(RPC::IRemoteConnection* connection);
         const string CreateInstance(const string& name, const Config& config);
+        void RegisterDiagnostics();
+        void UnregisterDiagnostics();
+        void RegisterKeywordDetection();
+        void UnregisterKeywordDetection();
+
+        // JSON-RPC diagnostics, only available when the implementation runs in process
+        uint32_t get_voicestatistics(Diagnostics::VoiceStatistics& response) const;
+        uint32_t get_memorystatistics(Diagnostics::MemoryStatistics& response) const;
+        uint32_t get_keywordstatistics(Diagnostics::KeywordStatistics& response) const;
+        uint32_t get_logstatistics(Diagnostics::LogStatistics& response) const;
+        uint32_t get_observerstatistics(Diagnostics::ObserverStatistics& response) const;
+        uint32_t endpoint_dumplog(Core::JSON::String& response);
+        uint32_t get_loglevel(const string& index, Core::JSON::String& response) const;
+        uint32_t set_loglevel(const string& index, const Core::JSON::String& param);
+
+        // JSON-RPC wake word control, only available when the implementation runs in process
+        uint32_t get_locale(Core::JSON::String& response) const;
+        uint32_t set_locale(const Core::JSON::String& param);
+        uint32_t get_keyword(Core::JSON::String& response) const;
+        uint32_t set_keyword(const Core::JSON::String& param);
+        uint32_t get_threshold(const string& index, Core::JSON::DecUInt32& response) const;
+        uint32_t set_threshold(const string& index, const Core::JSON::DecUInt32& param);
+        void event_voiceactivity(const bool active);
+        void event_keyworddetected(const string& keyword, const uint32_t confidence);
 
         Exchange::IAVSClient* _AVSClient;
         Exchange::IAVSController* _controller;
+        IAVSDiagnostics* _diagnostics;
+        IAVSKeywordDetection* _keywordDetection;
         PluginHost::IShell* _service;
         string _audiosourceName;
         uint32_t _connectionId;
         Core::Sink<AudiosourceNotification> _audiosourceNotification;
         Core::Sink<ConnectionNotification> _connectionNotification;
         Core::Sink<DialogueNotification> _dialogueNotification;
+        Core::Sink<KeywordNotification> _keywordNotification;
     };
 
 } // namespace Plugin
@@ -25,50 +25,63 @@ namespace Plugin {
     using namespace alexaClientSDK::avsCommon::sdkInterfaces;
     using namespace WPEFramework::Exchange;
 
+    constexpr size_t ThunderInputManager::OBSERVER_QUEUE_SIZE;
+    constexpr size_t ThunderInputManager::AVSController::NOTIFICATION_QUEUE_SIZE;
+
+    // Named after the Callback they are indexed by
+    static const std::vector<std::string> OBSERVER_CALLBACKS = { "rendertemplatecard", "receive", "dialoguxstate", "playeractivity" };
+    static const std::vector<std::string> NOTIFICATION_CALLBACKS = { "dialoguestatechange" };
+
  #if defined(ENABLE_SMART_SCREEN_SUPPORT)
  
      std::unique_ptr<ThunderInputManager>
- ThunderInputManager::create(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> guiManager)
+ ThunderInputManager::create(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> guiManager, std::shared_ptr<HttpDispatcher> dispatcher)
      {
              if (!guiManager) {
                      TRACE_GLOBAL(AVSClient, (_T("Invalid guiManager passed to ThunderInputManager")));
                      return nullptr;
                  }
-                 return std::unique_ptr<ThunderInputManager>(new ThunderInputManager(guiManager));
+                 return std::unique_ptr<ThunderInputManager>(new ThunderInputManager(guiManager, dispatcher));
              }
              
              ThunderInputManager::ThunderInputManager(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager>
-         guiManager)
+         guiManager, std::shared_ptr<HttpDispatcher> dispatcher)
                  : m_limitedInteraction{ false }
                 , m_playerState{alexaClientSDK::avsCommon::avs::PlayerActivity::IDLE}
                  , m_interactionManager{ nullptr }
                  , m_guiManager{ nullptr }
                  , m_controller{ WPEFramework::Core::ProxyType<AVSController>::Create(this) }
+                 , m_dispatcher{ dispatcher }
+                 , m_observerQueue(OBSERVER_CALLBACKS, OBSERVER_QUEUE_SIZE)
              {
                      TRACE_L1("Parsing VoiceToApps LEDs...");
                      m_vtaFlag = vta.ioParse();
+                     SubscribeDirectives();
                  }
                  
  #endif
 
 
-    std::unique_ptr<ThunderInputManager> ThunderInputManager::create(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager)
+    std::unique_ptr<ThunderInputManager> ThunderInputManager::create(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager, std::shared_ptr<HttpDispatcher> dispatcher)
     {
         if (!interactionManager) {
             TRACE_GLOBAL(AVSClient, (_T("Invalid InteractionManager passed to ThunderInputManager")));
             return nullptr;
         }
-        return std::unique_ptr<ThunderInputManager>(new ThunderInputManager(interactionManager));
+        return std::unique_ptr<ThunderInputManager>(new ThunderInputManager(interactionManager, dispatcher));
     }
 
-    ThunderInputManager::ThunderInputManager(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager)
+    ThunderInputManager::ThunderInputManager(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager, std::shared_ptr<HttpDispatcher> dispatcher)
         : m_limitedInteraction{ false }
         , m_interactionManager{ interactionManager }
         , m_controller{ WPEFramework::Core::ProxyType<AVSController>::Create(this) }
         , m_playerState{alexaClientSDK::avsCommon::avs::PlayerActivity::IDLE}
+        , m_dispatcher{ dispatcher }
+        , m_observerQueue(OBSERVER_CALLBACKS, OBSERVER_QUEUE_SIZE)
     {
         TRACE_L1("Parsing VoiceToApps LEDs...");
         m_vtaFlag = vta.ioParse();
+        SubscribeDirectives();
     }
 
        // to check if audioPlayer is in playing/buffering/paused state
@@ -78,7 +91,7 @@ namespace Plugin {
        bool state=(m_playerState == PlayerActivity::PLAYING) || 
            (m_playerState == PlayerActivity::BUFFER_UNDERRUN) ||
            (m_playerState == PlayerActivity::PAUSED);
-                std::cout << __func__ << "Current Aud State =" << state <<std::endl;
+                TRACE_L1("Current audio state = %d", state);
                 return state;
    }
   
@@ -86,42 +99,34 @@ namespace Plugin {
 
        {
                 m_playerState = state; 
-       std::cout << " onPlayerActivityChanged:  State change called ";
       using namespace skillmapper;
            using namespace alexaClientSDK::avsCommon::avs;
        AudioPlayerState smState;
        switch (state) {
        case PlayerActivity::IDLE:
-           std::cout << "idle ";
            smState = AudioPlayerState::IDLE; 
            break;
        case PlayerActivity::PLAYING:
-           std::cout << "playing ";
            smState = AudioPlayerState::PLAYING; 
            break;
        case PlayerActivity::STOPPED:
-          std::cout << "stopped" ;
            smState = AudioPlayerState::STOPPED; 
            break;
        case PlayerActivity::PAUSED:
-           std::cout << "paused ";
            smState = AudioPlayerState::PAUSED; 
            break;
        case PlayerActivity::BUFFER_UNDERRUN:
-           std::cout << "bufferring ";
            smState = AudioPlayerState::BUFFER_UNDERRUN; 
            break;
        case PlayerActivity::FINISHED:
-           std::cout << "finished ";
            smState = AudioPlayerState::FINISHED; 
            break;
        default:
-           std::cout << "unknown ";
            smState = AudioPlayerState::UNKNOWN; 
        }
 
-       std::cout << std::endl;
-       vta.handleAudioPlayerStateChangeNotification(smState);
+       TRACE_L1("onPlayerActivityChanged: %s", playerActivityToString(state).c_str());
+       m_observerQueue.SubmitState(PLAYER_STATE, static_cast<uint32_t>(smState), [this, smState]() { vta.handleAudioPlayerStateChangeNotification(smState); });
    }
 
 
@@ -140,8 +145,8 @@ namespace Plugin {
           return;
         }
 
-        printf("VoiceToApps template card: %s ...\n", jsonPayload.c_str());
-        vta.curlCmdSendOnRcvMsg(jsonPayload);
+        TRACE_L1("VoiceToApps template card: %s ...", jsonPayload.c_str());
+        Forward(TEMPLATE_CARD, jsonPayload);
     }
 
     void  ThunderInputManager::renderPlayerInfoCard (const std::string &jsonPayload, 
@@ -168,23 +173,31 @@ namespace Plugin {
             return;
         }
 
-        std::string key = "\"namespace\":\"SpeechSynthesizer\",\"name\":\"Speak\"";
-        if(std::string::npos!=message.find(key,0) )
-            vta.curlCmdSendOnRcvMsg(message);
+        m_directives.Route(message);
     }
 
-    ThunderInputManager::AVSController::AVSController(ThunderInputManager* parent)
-        : m_parent(*parent)
-        , m_notifications()
+    // The directives VoiceToApps is triggered by
+    void ThunderInputManager::SubscribeDirectives()
     {
+        m_directives.Subscribe("SpeechSynthesizer", "Speak", [this](const std::string& message) {
+            Forward(DIRECTIVE, message);
+        });
     }
 
-    ThunderInputManager::AVSController::~AVSController()
+    void ThunderInputManager::Forward(const Callback callback, const std::string& document)
     {
-        for (auto* notification : m_notifications) {
-            notification->Release();
+        // Queued by the dispatcher, this does not wait for the post
+        const bool isDispatched = ((m_dispatcher) && (m_dispatcher->IsValid() == true) && (m_dispatcher->Post(document) == true));
+        if (isDispatched == false) {
+            m_observerQueue.Submit(callback, [this, document]() { vta.curlCmdSendOnRcvMsg(document); });
         }
-        m_notifications.clear();
+    }
+
+    ThunderInputManager::AVSController::AVSController(ThunderInputManager* parent)
+        : m_parent(*parent)
+        , m_notifications()
+        , m_notificationQueue(NOTIFICATION_CALLBACKS, NOTIFICATION_QUEUE_SIZE)
+    {
     }
 
     void ThunderInputManager::AVSController::NotifyDialogUXStateChanged(DialogUXState newState)
@@ -192,6 +205,7 @@ namespace Plugin {
         IAVSController::INotification::dialoguestate dialoguestate;
         bool isStateHandled = true;
         using namespace skillmapper;
+        VoiceSDKState vtaState = VoiceSDKState::VTA_IDLE;
         bool smartScreenEnabled = 0;
         //bool (*audStateCb)(void)= &ThunderInputManager::isAudioPlaying;
        
@@ -205,36 +219,23 @@ namespace Plugin {
    
         switch (newState) {
         case DialogUXState::IDLE:
-            m_parent.vta.handleSDKStateChangeNotification(VoiceSDKState::VTA_IDLE, smartScreenEnabled,m_parent.isAudioPlaying() );
-            std::cout << "Calling Smart screen notification with idle status " << std::endl;
+            vtaState = VoiceSDKState::VTA_IDLE;
             dialoguestate = IAVSController::INotification::IDLE;
             break;
         case DialogUXState::LISTENING:
-            m_parent.vta.handleSDKStateChangeNotification(VoiceSDKState::VTA_LISTENING, smartScreenEnabled,m_parent.isAudioPlaying());
+            vtaState = VoiceSDKState::VTA_LISTENING;
             dialoguestate = IAVSController::INotification::LISTENING;
             break;
         case DialogUXState::EXPECTING:
-            m_parent.vta.handleSDKStateChangeNotification(VoiceSDKState::VTA_EXPECTING, smartScreenEnabled, m_parent.isAudioPlaying());
-#ifdef FILEAUDIO
-            if ( m_parent.vta.invocationMode ){
-                 m_parent.vta.fromExpecting=true;
-                 m_parent.vta.skipMerge=true;
-            }
-#endif
+            vtaState = VoiceSDKState::VTA_EXPECTING;
             dialoguestate = IAVSController::INotification::EXPECTING;
             break;
         case DialogUXState::THINKING:
-            m_parent.vta.handleSDKStateChangeNotification(VoiceSDKState::VTA_THINKING, smartScreenEnabled, m_parent.isAudioPlaying() );
+            vtaState = VoiceSDKState::VTA_THINKING;
             dialoguestate = IAVSController::INotification::THINKING;
             break;
         case DialogUXState::SPEAKING:
-            m_parent.vta.handleSDKStateChangeNotification(VoiceSDKState::VTA_SPEAKING, smartScreenEnabled,m_parent.isAudioPlaying() );
-#ifdef FILEAUDIO
-            if ( m_parent.vta.fromExpecting ) {
-                 m_parent.vta.fromExpecting=false;
-                 m_parent.vta.skipMerge=false;
-            }
-#endif
+            vtaState = VoiceSDKState::VTA_SPEAKING;
             dialoguestate = IAVSController::INotification::SPEAKING;
             break;
         case DialogUXState::FINISHED:
@@ -247,8 +248,22 @@ namespace Plugin {
         }
 
         if (isStateHandled == true) {
-            for (auto* notification : m_notifications) {
-                notification->DialogueStateChange(dialoguestate);
+            // The audio state as it is now, not when the queue gets to it
+            ThunderInputManager* parent = &m_parent;
+            const bool audioPlaying = m_parent.isAudioPlaying();
+            const uint32_t state = ((static_cast<uint32_t>(vtaState) << 1) | (audioPlaying ? 1 : 0));
+            m_parent.m_observerQueue.SubmitState(DIALOG_STATE, state, [parent, vtaState, smartScreenEnabled, audioPlaying]() {
+                parent->HandleDialogState(vtaState, smartScreenEnabled, audioPlaying);
+            });
+
+            // The sinks may be remote, a slow one must not hold up the SDK
+            if (m_notifications.IsEmpty() == false) {
+                AVSController* controller = this;
+                m_notificationQueue.SubmitState(0, static_cast<uint32_t>(dialoguestate), [controller, dialoguestate]() {
+                    controller->m_notifications.ForEach([dialoguestate](IAVSController::INotification* notification) {
+                        notification->DialogueStateChange(dialoguestate);
+                    });
+                });
             }
         }
     }
@@ -256,19 +271,16 @@ namespace Plugin {
     void ThunderInputManager::AVSController::Register(INotification* notification)
     {
         ASSERT(notification != nullptr);
-        notification->AddRef();
-        m_notifications.push_back(notification);
+
+        m_notifications.Register(notification);
     }
 
     void ThunderInputManager::AVSController::Unregister(const INotification* notification)
     {
         ASSERT(notification != nullptr);
 
-        auto item = std::find(m_notifications.begin(), m_notifications.end(), notification);
-        if (item != m_notifications.end()) {
-            m_notifications.erase(item);
-            (*item)->Release();
-        }
+        // Does not wait for a fan-out, a sink may unregister from its own DialogueStateChange()
+        m_notifications.Unregister(notification);
     }
 
     uint32_t ThunderInputManager::AVSController::Mute(const bool mute)
@@ -303,6 +315,43 @@ namespace Plugin {
         return (&(*m_controller));
     }
 
+    void ThunderInputManager::Statistics(Diagnostics::ObserverStatistics& statistics) const
+    {
+        m_observerQueue.Statistics(statistics);
+        if (m_dispatcher) {
+            const HttpDispatcher::Statistics counters = m_dispatcher->Counters();
+            statistics.Dispatcher.Posts = counters.posts;
+            statistics.Dispatcher.Coalesced = counters.coalesced;
+            statistics.Dispatcher.Dropped = counters.dropped;
+            statistics.Dispatcher.Sent = counters.sent;
+            statistics.Dispatcher.Retried = counters.retried;
+            statistics.Dispatcher.Failed = counters.failed;
+            statistics.Dispatcher.Connects = counters.connects;
+            statistics.Dispatcher.Latency = counters.averageLatency;
+            statistics.Dispatcher.MaxLatency = counters.maxLatency;
+        }
+    }
+
+    // Runs on the thread of m_observerQueue, the only one using vta
+    void ThunderInputManager::HandleDialogState(const skillmapper::VoiceSDKState state, const bool smartScreenEnabled, const bool audioPlaying)
+    {
+        using namespace skillmapper;
+
+        vta.handleSDKStateChangeNotification(state, smartScreenEnabled, audioPlaying);
+        if (state == VoiceSDKState::VTA_IDLE) {
+            TRACE_L1("Calling Smart screen notification with idle status");
+        }
+#ifdef FILEAUDIO
+        if ((state == VoiceSDKState::VTA_EXPECTING) && (vta.invocationMode)) {
+            vta.fromExpecting = true;
+            vta.skipMerge = true;
+        } else if ((state == VoiceSDKState::VTA_SPEAKING) && (vta.fromExpecting)) {
+            vta.fromExpecting = false;
+            vta.skipMerge = false;
+        }
+#endif
+    }
+
     void ThunderInputManager::onLogout()
     {
         m_limitedInteraction = true;
@@ -19,6 +19,11 @@
 
 #pragma once
 #include <VoiceToApps/VoiceToApps.h>
+#include "CopyOnWriteRegistry.h"
+#include "DirectiveRouter.h"
+#include "HttpDispatcher.h"
+#include "IAVSDiagnostics.h"
+#include "ObserverQueue.h"
 #include "TraceCategories.h"
 
 #include <WPEFramework/interfaces/IAVSClient.h>
@@ -34,6 +39,9 @@
 #endif
 
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace WPEFramework {
 namespace Plugin {
@@ -49,19 +57,19 @@ namespace Plugin {
           //public alexaClientSDK::avsCommon::sdkInterfaces::AudioPlayerObserverInterface,
 		  public alexaClientSDK::avsCommon::sdkInterfaces::MessageObserverInterface {
     public:
-        static std::unique_ptr<ThunderInputManager> create(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager);
+        static std::unique_ptr<ThunderInputManager> create(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager, std::shared_ptr<HttpDispatcher> dispatcher = nullptr);
         #if defined(ENABLE_SMART_SCREEN_SUPPORT)
-        static std::unique_ptr<ThunderInputManager> create(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> guiManager);
+        static std::unique_ptr<ThunderInputManager> create(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> guiManager, std::shared_ptr<HttpDispatcher> dispatcher = nullptr);
         #endif
 	skillmapper::voiceToApps vta;
 	int m_vtaFlag;
-    alexaClientSDK::avsCommon::avs::PlayerActivity m_playerState;
+    std::atomic<alexaClientSDK::avsCommon::avs::PlayerActivity> m_playerState;
         class AVSController : public WPEFramework::Exchange::IAVSController {
         public:
             AVSController(const AVSController&) = delete;
             AVSController& operator=(const AVSController&) = delete;
             AVSController(ThunderInputManager* parent);
-            ~AVSController();
+            ~AVSController() = default;
 
             void NotifyDialogUXStateChanged(DialogUXState newState);
 
@@ -76,8 +84,12 @@ namespace Plugin {
             END_INTERFACE_MAP
 
         private:
+            static constexpr size_t NOTIFICATION_QUEUE_SIZE = 16;
+
             ThunderInputManager& m_parent;
-            std::list<WPEFramework::Exchange::IAVSController::INotification*> m_notifications;
+            CopyOnWriteRegistry<WPEFramework::Exchange::IAVSController::INotification> m_notifications;
+            // Last, so its thread is gone before the sinks are released
+            ObserverQueue m_notificationQueue;
         };
 
         void onLogout() override;
@@ -96,12 +108,25 @@ namespace Plugin {
 
 
         WPEFramework::Exchange::IAVSController* Controller();
+        void Statistics(Diagnostics::ObserverStatistics& statistics) const;
 
     private:
-        ThunderInputManager(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager);
+        // The observer callbacks that hand their VoiceToApps work to m_observerQueue
+        enum Callback : uint8_t {
+            TEMPLATE_CARD,
+            DIRECTIVE,
+            DIALOG_STATE,
+            PLAYER_STATE
+        };
+        static constexpr size_t OBSERVER_QUEUE_SIZE = 64;
+
+        ThunderInputManager(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager, std::shared_ptr<HttpDispatcher> dispatcher);
 #if defined(ENABLE_SMART_SCREEN_SUPPORT)
-         ThunderInputManager(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> guiManager);
+         ThunderInputManager(std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> guiManager, std::shared_ptr<HttpDispatcher> dispatcher);
 #endif
+        void SubscribeDirectives();
+        void Forward(const Callback callback, const std::string& document);
+        void HandleDialogState(const skillmapper::VoiceSDKState state, const bool smartScreenEnabled, const bool audioPlaying);
         void onAuthStateChange(AuthObserverInterface::State newState, AuthObserverInterface::Error newError) override;
 		void onCapabilitiesStateChange (CapabilitiesDelegateObserverInterface::State newState, CapabilitiesDelegateObserverInterface::Error newError, const std::vector< std::string > &addedOrUpdatedEndpointIds, const std::vector< std::string > &deletedEndpointIds) override;
 
@@ -111,6 +136,11 @@ namespace Plugin {
                std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> m_guiManager;
        #endif
         std::atomic_bool m_limitedInteraction;
+        DirectiveRouter m_directives;
+        // Posts the documents for VoiceToApps itself when there is one
+        std::shared_ptr<HttpDispatcher> m_dispatcher;
+        // Last, so its thread is gone before anything it uses
+        ObserverQueue m_observerQueue;
     };
 
 } // namespace Plugin
@@ -0,0 +1,230 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AudioConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Filter length per output phase at unity ratio; scaled up when decimating
+    static constexpr size_t TAPS_PER_PHASE = 16;
+    // Passband edge relative to the lower of the two Nyquist frequencies
+    static constexpr double ROLLOFF = 0.92;
+    // Kaiser window shape, roughly 80 dB stop band attenuation
+    static constexpr double KAISER_BETA = 7.857;
+
+    static uint32_t GreatestCommonDivisor(uint32_t a, uint32_t b)
+    {
+        while (b != 0) {
+            const uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    // Zeroth order modified Bessel function of the first kind
+    static double BesselI0(const double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (uint32_t k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static inline float Dot(const float a[], const float b[], const size_t length)
+    {
+        size_t i = 0;
+        float sum = 0.0f;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (; (i + 4) <= length; i += 4) {
+            acc = vmlaq_f32(acc, vld1q_f32(&a[i]), vld1q_f32(&b[i]));
+        }
+        const float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+        sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+#elif defined(__SSE__)
+        __m128 acc = _mm_setzero_ps();
+        for (; (i + 4) <= length; i += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+        float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (; (i + 4) <= length; i += 4) {
+            acc[0] += a[i] * b[i];
+            acc[1] += a[i + 1] * b[i + 1];
+            acc[2] += a[i + 2] * b[i + 2];
+            acc[3] += a[i + 3] * b[i + 3];
+        }
+        sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+
+        for (; i < length; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    static inline int16_t Saturate(const float value)
+    {
+        const float rounded = std::floor(value + 0.5f);
+        return static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, rounded)));
+    }
+
+    constexpr uint32_t AudioConverter::MAX_PHASES;
+
+    /* static */ bool AudioConverter::IsSupported(const uint32_t inputRate, const uint32_t outputRate)
+    {
+        return ((inputRate != 0) && (outputRate != 0) && ((outputRate / GreatestCommonDivisor(inputRate, outputRate)) <= MAX_PHASES));
+    }
+
+    AudioConverter::AudioConverter()
+        : m_interpolation{ 1 }
+        , m_decimation{ 1 }
+        , m_channels{ 1 }
+        , m_tapsPerPhase{ 1 }
+        , m_phase{ 0 }
+        , m_taps(1, 1.0f)
+        , m_window()
+        , m_history{ 0 }
+    {
+    }
+
+    bool AudioConverter::Configure(const uint32_t inputRate, const uint8_t channels, const uint32_t outputRate, const size_t maxInputFrames)
+    {
+        if ((channels == 0) || (IsSupported(inputRate, outputRate) == false)) {
+            return false;
+        }
+
+        const uint32_t divisor = GreatestCommonDivisor(inputRate, outputRate);
+        const uint32_t interpolation = outputRate / divisor;
+        const uint32_t decimation = inputRate / divisor;
+
+        m_interpolation = interpolation;
+        m_decimation = decimation;
+        m_channels = channels;
+
+        if (m_interpolation == m_decimation) {
+            m_tapsPerPhase = 1;
+            m_taps.assign(1, 1.0f);
+        } else {
+            const size_t stretch = (m_decimation + m_interpolation - 1) / m_interpolation;
+            m_tapsPerPhase = TAPS_PER_PHASE * std::max<size_t>(1, stretch);
+            DesignFilter();
+        }
+
+        m_window.assign((m_tapsPerPhase - 1) + maxInputFrames, 0.0f);
+        Reset();
+
+        return true;
+    }
+
+    void AudioConverter::Reset()
+    {
+        m_phase = 0;
+        m_history = m_tapsPerPhase - 1;
+        std::fill(m_window.begin(), m_window.end(), 0.0f);
+    }
+
+    void AudioConverter::DesignFilter()
+    {
+        const size_t length = m_interpolation * m_tapsPerPhase;
+        const double center = (static_cast<double>(length) - 1.0) / 2.0;
+        const double cutoff = (0.5 * ROLLOFF) / std::max(m_interpolation, m_decimation);
+        const double normalizer = BesselI0(KAISER_BETA);
+
+        std::vector<double> prototype(length);
+        for (size_t k = 0; k < length; ++k) {
+            const double x = static_cast<double>(k) - center;
+            const double sinc = (x == 0.0) ? 1.0 : (std::sin(2.0 * M_PI * cutoff * x) / (2.0 * M_PI * cutoff * x));
+            const double ratio = x / center;
+            const double window = BesselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - (ratio * ratio)))) / normalizer;
+            prototype[k] = sinc * window;
+        }
+
+        // Split into phases, reverse each one and give it unity gain at DC
+        m_taps.assign(length, 0.0f);
+        for (uint32_t phase = 0; phase < m_interpolation; ++phase) {
+            double gain = 0.0;
+            for (size_t j = 0; j < m_tapsPerPhase; ++j) {
+                gain += prototype[phase + (j * m_interpolation)];
+            }
+            for (size_t j = 0; j < m_tapsPerPhase; ++j) {
+                const double tap = prototype[phase + (j * m_interpolation)] / gain;
+                m_taps[(phase * m_tapsPerPhase) + (m_tapsPerPhase - 1 - j)] = static_cast<float>(tap);
+            }
+        }
+    }
+
+    size_t AudioConverter::Process(const int16_t input[], const size_t frames, int16_t output[], const size_t capacity)
+    {
+        const size_t accepted = std::min(frames, m_window.size() - m_history);
+        float* mono = &m_window[m_history];
+
+        if (m_channels == 1) {
+            for (size_t frame = 0; frame < accepted; ++frame) {
+                mono[frame] = input[frame];
+            }
+        } else {
+            const float scale = 1.0f / m_channels;
+            for (size_t frame = 0; frame < accepted; ++frame) {
+                int32_t sum = 0;
+                for (uint8_t channel = 0; channel < m_channels; ++channel) {
+                    sum += input[(frame * m_channels) + channel];
+                }
+                mono[frame] = sum * scale;
+            }
+        }
+
+        const size_t available = m_history + accepted;
+        size_t index = 0;
+        size_t produced = 0;
+
+        while (((index + m_tapsPerPhase) <= available) && (produced < capacity)) {
+            output[produced++] = Saturate(Dot(&m_window[index], &m_taps[m_phase * m_tapsPerPhase], m_tapsPerPhase));
+            m_phase += m_decimation;
+            index += m_phase / m_interpolation;
+            m_phase %= m_interpolation;
+        }
+
+        m_history = available - index;
+        ::memmove(m_window.data(), &m_window[index], m_history * sizeof(float));
+
+        return produced;
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
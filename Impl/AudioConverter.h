@@ -0,0 +1,86 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Streaming down-mixer and polyphase resampler for 16-bit PCM.
+     *
+     * Interleaved input of any channel count is averaged to mono and resampled by the
+     * rational factor outputRate/inputRate. All buffers are sized by Configure(), so
+     * Process() does not allocate.
+     */
+    class AudioConverter {
+    public:
+        AudioConverter(const AudioConverter&) = delete;
+        AudioConverter& operator=(const AudioConverter&) = delete;
+
+        AudioConverter();
+        ~AudioConverter() = default;
+
+    public:
+        // Whether Configure() accepts the rate pair, the ratio must reduce to at most MAX_PHASES phases
+        static bool IsSupported(const uint32_t inputRate, const uint32_t outputRate);
+
+        bool Configure(const uint32_t inputRate, const uint8_t channels, const uint32_t outputRate, const size_t maxInputFrames);
+        void Reset();
+
+        bool IsPassThrough() const
+        {
+            return ((m_interpolation == m_decimation) && (m_channels == 1));
+        }
+
+        // Upper bound of the samples produced for the given number of input frames
+        size_t MaxOutputSamples(const size_t frames) const
+        {
+            return (((frames * m_interpolation) / m_decimation) + 1);
+        }
+
+        /// Converts frames of interleaved input, returns the number of mono samples written to output.
+        size_t Process(const int16_t input[], const size_t frames, int16_t output[], const size_t capacity);
+
+    private:
+        // 11.025 kHz to 16 kHz reduces to 640/441, the most of the common rates between 8 and 48 kHz
+        static constexpr uint32_t MAX_PHASES = 640;
+
+        void DesignFilter();
+
+    private:
+        uint32_t m_interpolation;
+        uint32_t m_decimation;
+        uint8_t m_channels;
+        size_t m_tapsPerPhase;
+        uint32_t m_phase;
+
+        // Per phase filter taps, stored reversed so that each output is a plain dot product
+        std::vector<float> m_taps;
+        // History of tapsPerPhase - 1 mono samples followed by the current input
+        std::vector<float> m_window;
+        size_t m_history;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,194 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Bounded single-producer/single-consumer ring of voice packets.
+     *
+     * The producer is the COM-RPC thread delivering IVoiceHandler::Data(), the consumer is
+     * the thread that owns the SDS writer. Packets are stored as a small header followed by
+     * the payload, so packet boundaries and sequence numbers survive the hand-over.
+     * Push() never blocks: a packet that does not fit is dropped and counted.
+     */
+    class AudioStagingRing {
+    public:
+        struct Header {
+            uint32_t sequenceNo;
+            uint16_t length;
+            uint16_t flags;
+        };
+
+        struct Statistics {
+            size_t capacity;
+            size_t occupancy;
+            size_t highWaterMark;
+            uint64_t pushedPackets;
+            uint64_t droppedPackets;
+            uint64_t droppedBytes;
+        };
+
+        AudioStagingRing(const AudioStagingRing&) = delete;
+        AudioStagingRing& operator=(const AudioStagingRing&) = delete;
+
+        explicit AudioStagingRing(const size_t capacity)
+            : m_capacity{ capacity }
+            , m_buffer{ new uint8_t[capacity] }
+            , m_head{ 0 }
+            , m_tail{ 0 }
+            , m_highWaterMark{ 0 }
+            , m_pushedPackets{ 0 }
+            , m_droppedPackets{ 0 }
+            , m_droppedBytes{ 0 }
+        {
+        }
+
+        ~AudioStagingRing() = default;
+
+    public:
+        // Producer side
+        bool Push(const uint32_t sequenceNo, const uint8_t data[], const uint16_t length, const uint16_t flags = 0)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            const size_t tail = m_tail.load(std::memory_order_acquire);
+            const size_t needed = sizeof(Header) + length;
+
+            if ((m_capacity - (head - tail)) < needed) {
+                m_droppedPackets.fetch_add(1, std::memory_order_relaxed);
+                m_droppedBytes.fetch_add(length, std::memory_order_relaxed);
+                return false;
+            }
+
+            const Header header = { sequenceNo, length, flags };
+            Copy(head, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+            if (length > 0) {
+                Copy(head + sizeof(header), data, length);
+            }
+            m_head.store(head + needed, std::memory_order_release);
+
+            const size_t occupancy = head + needed - tail;
+            size_t highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+            while ((occupancy > highWaterMark) && (m_highWaterMark.compare_exchange_weak(highWaterMark, occupancy, std::memory_order_relaxed) == false)) {
+            }
+            m_pushedPackets.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Consumer side. Returns false when the ring is empty or the packet does not fit into data.
+        bool Pop(Header& header, uint8_t data[], const uint16_t maxLength)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t head = m_head.load(std::memory_order_acquire);
+
+            if (head == tail) {
+                return false;
+            }
+
+            Extract(tail, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+            const bool fits = (header.length <= maxLength);
+            if ((fits == true) && (header.length > 0)) {
+                Extract(tail + sizeof(header), data, header.length);
+            }
+            m_tail.store(tail + sizeof(header) + header.length, std::memory_order_release);
+
+            if (fits == false) {
+                m_droppedPackets.fetch_add(1, std::memory_order_relaxed);
+                m_droppedBytes.fetch_add(header.length, std::memory_order_relaxed);
+            }
+
+            return fits;
+        }
+
+        bool IsEmpty() const
+        {
+            return (m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire));
+        }
+
+        // Byte position up to which packets were pushed, only meaningful on the producer side
+        size_t Head() const
+        {
+            return m_head.load(std::memory_order_relaxed);
+        }
+
+        // Byte position up to which packets were popped, only meaningful on the consumer side
+        size_t Tail() const
+        {
+            return m_tail.load(std::memory_order_relaxed);
+        }
+
+        Statistics Counters() const
+        {
+            Statistics statistics;
+            statistics.capacity = m_capacity;
+            statistics.occupancy = m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed);
+            statistics.highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+            statistics.pushedPackets = m_pushedPackets.load(std::memory_order_relaxed);
+            statistics.droppedPackets = m_droppedPackets.load(std::memory_order_relaxed);
+            statistics.droppedBytes = m_droppedBytes.load(std::memory_order_relaxed);
+            return statistics;
+        }
+
+    private:
+        static constexpr size_t CACHE_LINE = 64;
+
+        void Copy(const size_t position, const uint8_t data[], const size_t length)
+        {
+            const size_t offset = position % m_capacity;
+            const size_t first = std::min(length, m_capacity - offset);
+            ::memcpy(&m_buffer[offset], data, first);
+            ::memcpy(&m_buffer[0], &data[first], length - first);
+        }
+
+        void Extract(const size_t position, uint8_t data[], const size_t length) const
+        {
+            const size_t offset = position % m_capacity;
+            const size_t first = std::min(length, m_capacity - offset);
+            ::memcpy(data, &m_buffer[offset], first);
+            ::memcpy(&data[first], &m_buffer[0], length - first);
+        }
+
+    private:
+        const size_t m_capacity;
+        std::unique_ptr<uint8_t[]> m_buffer;
+
+        // Monotonic byte positions; the difference is the occupancy. Kept on separate cache lines.
+        uint8_t m_padding0[CACHE_LINE];
+        std::atomic<size_t> m_head;
+        uint8_t m_padding1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> m_tail;
+        uint8_t m_padding2[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+        std::atomic<size_t> m_highWaterMark;
+        std::atomic<uint64_t> m_pushedPackets;
+        std::atomic<uint64_t> m_droppedPackets;
+        std::atomic<uint64_t> m_droppedBytes;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,111 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AudioStreamBuffer.h"
+#include "TraceCategories.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    AudioStreamBuffer::AudioStreamBuffer()
+        : m_settings()
+        , m_buffer()
+        , m_dataSize{ 0 }
+        , m_isLocked{ false }
+        , m_isHugePages{ false }
+    {
+    }
+
+    AudioStreamBuffer::~AudioStreamBuffer()
+    {
+        if ((m_isLocked == true) && (m_buffer)) {
+            ::munlock(m_buffer->data(), m_buffer->size());
+        }
+    }
+
+    std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> AudioStreamBuffer::Create(const AudioStreamSettings& settings, const uint32_t sampleRate)
+    {
+        using alexaClientSDK::avsCommon::avs::AudioInputStream;
+
+        // A buffer of an earlier stream may still be used by its readers, it is just no longer locked
+        if ((m_isLocked == true) && (m_buffer)) {
+            ::munlock(m_buffer->data(), m_buffer->size());
+        }
+        m_isLocked = false;
+        m_isHugePages = false;
+
+        m_settings = settings;
+        m_dataSize = sampleRate * settings.duration.count();
+
+        const size_t bufferSize = AudioInputStream::calculateBufferSize(m_dataSize, settings.wordSize, settings.readers);
+        if (bufferSize == 0) {
+            TRACE_GLOBAL(AVSClient, (_T("Invalid shared data stream layout")));
+            return nullptr;
+        }
+        // Reserved first and filled after madvise(), so the pages are first touched as huge pages.
+        // The SDK's buffer type comes with the standard allocator, the memory can not be aligned.
+        m_buffer = std::make_shared<AudioInputStream::Buffer>();
+        m_buffer->reserve(bufferSize);
+
+        if (settings.hugePages == true) {
+            const uintptr_t start = reinterpret_cast<uintptr_t>(m_buffer->data());
+            const uintptr_t first = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+            const uintptr_t last = (start + bufferSize) & ~(HUGE_PAGE_SIZE - 1);
+            m_isHugePages = ((last > first) && (::madvise(reinterpret_cast<void*>(first), last - first, MADV_HUGEPAGE) == 0));
+            if (m_isHugePages == false) {
+                TRACE_GLOBAL(AVSClient, (_T("Shared data stream of %zu bytes can not be backed by huge pages"), bufferSize));
+            }
+        }
+        m_buffer->resize(bufferSize);
+
+        if (settings.lock == true) {
+            m_isLocked = (::mlock(m_buffer->data(), bufferSize) == 0);
+            if (m_isLocked == false) {
+                TRACE_GLOBAL(AVSClient, (_T("Failed to lock %zu bytes of shared data stream in memory"), bufferSize));
+            }
+        }
+
+        std::shared_ptr<AudioInputStream> stream = AudioInputStream::create(m_buffer, settings.wordSize, settings.readers);
+        if (stream) {
+            TRACE_GLOBAL(AVSClient, (_T("Shared data stream of %zu bytes: %zu bytes of audio, %zu readers"), bufferSize, m_dataSize * settings.wordSize, settings.readers));
+        }
+
+        return stream;
+    }
+
+    void AudioStreamBuffer::Report(Diagnostics::MemoryStatistics& statistics) const
+    {
+        const size_t dataBytes = m_dataSize * m_settings.wordSize;
+
+        statistics.Readers = static_cast<uint32_t>(m_settings.readers);
+        statistics.WordSize = static_cast<uint8_t>(m_settings.wordSize);
+        statistics.Duration = static_cast<uint32_t>(m_settings.duration.count());
+        statistics.BufferSize = dataBytes;
+        statistics.OverheadSize = (m_buffer) ? (m_buffer->size() - dataBytes) : 0;
+        statistics.Locked = m_isLocked;
+        statistics.HugePages = m_isHugePages;
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,81 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+#include "IAVSDiagnostics.h"
+
+#include <AVSCommon/AVS/AudioInputStream.h>
+
+#include <chrono>
+#include <memory>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /// Sizing of the shared data stream that carries the microphone audio
+    struct AudioStreamSettings {
+        AudioStreamSettings()
+            : readers{ 10 }
+            , wordSize{ 2 }
+            , duration{ 15 }
+            , lock{ false }
+            , hugePages{ false }
+        {
+        }
+
+        size_t readers;
+        size_t wordSize;
+        std::chrono::seconds duration;
+        // Keep the buffer resident in RAM
+        bool lock;
+        // Ask for transparent huge pages on the buffer
+        bool hugePages;
+    };
+
+    /**
+     * Owns the memory of the shared data stream and accounts for it.
+     *
+     * The SDK's buffer is a std::vector, so it can not be allocated aligned. Huge pages are requested
+     * with madvise() after reserving it and before it is first written, and only cover the 2 MB
+     * aligned part of it.
+     */
+    class AudioStreamBuffer {
+    public:
+        AudioStreamBuffer(const AudioStreamBuffer&) = delete;
+        AudioStreamBuffer& operator=(const AudioStreamBuffer&) = delete;
+
+        AudioStreamBuffer();
+        ~AudioStreamBuffer();
+
+    public:
+        std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> Create(const AudioStreamSettings& settings, const uint32_t sampleRate);
+        void Report(Diagnostics::MemoryStatistics& statistics) const;
+
+    private:
+        AudioStreamSettings m_settings;
+        std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream::Buffer> m_buffer;
+        size_t m_dataSize;
+        bool m_isLocked;
+        bool m_isHugePages;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "AudioConverter.h"
 #include "TraceCategories.h"
 
 #include <AVSCommon/Utils/AudioFormat.h>
@@ -61,6 +62,29 @@ namespace Plugin {
             return true;
         }
 
+        // Input formats the ThunderVoiceHandler can down-mix and resample into the compatible format
+        static constexpr unsigned int MIN_INPUT_SAMPLE_RATE_HZ = 8000;
+        static constexpr unsigned int MAX_INPUT_SAMPLE_RATE_HZ = 48000;
+        static constexpr unsigned int MAX_INPUT_CHANNELS = 8;
+
+        static bool IsConvertible(const unsigned int sampleRateHz, const unsigned int numChannels, const unsigned int sampleSizeInBits)
+        {
+            if (SAMPLE_SIZE_IN_BITS != sampleSizeInBits) {
+                TRACE_GLOBAL(AVSClient, (_T("Unsupported input sample size in bits (%u)"), sampleSizeInBits));
+                return false;
+            }
+            if ((sampleRateHz < MIN_INPUT_SAMPLE_RATE_HZ) || (sampleRateHz > MAX_INPUT_SAMPLE_RATE_HZ) || (AudioConverter::IsSupported(sampleRateHz, SAMPLE_RATE_HZ) == false)) {
+                TRACE_GLOBAL(AVSClient, (_T("Unsupported input sample rate (%u)"), sampleRateHz));
+                return false;
+            }
+            if ((numChannels == 0) || (numChannels > MAX_INPUT_CHANNELS)) {
+                TRACE_GLOBAL(AVSClient, (_T("Unsupported input number of channels (%u)"), numChannels));
+                return false;
+            }
+
+            return true;
+        }
+
     } // namespace AudioFormatCompatibility
 } // namespace Plugin
 } // namespace WPEFramework
@@ -0,0 +1,155 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Set of notification sinks that is fanned out to without a lock.
+     *
+     * Register() and Unregister() replace the array as a whole, a fan-out works on the array that was
+     * current when it started. Every sink carries a flag that Unregister() clears before it returns and
+     * that ForEach() checks right before each call, so an unregistered sink is not called by a fan-out
+     * that started earlier. Unregister() never waits for a fan-out, a sink may unregister from inside
+     * its own callback, on any thread. A reference to the sink is held for as long as an array refers
+     * to it, so a call that was already under way when the sink unregistered finishes on a valid sink.
+     */
+    template <typename INTERFACE>
+    class CopyOnWriteRegistry {
+    private:
+        class Entry {
+        public:
+            Entry(const Entry&) = delete;
+            Entry& operator=(const Entry&) = delete;
+
+            explicit Entry(INTERFACE* sink)
+                : m_sink(sink)
+                , m_isRegistered(true)
+            {
+                m_sink->AddRef();
+            }
+            ~Entry()
+            {
+                m_sink->Release();
+            }
+
+        public:
+            INTERFACE* Sink() const
+            {
+                return (m_sink);
+            }
+            bool IsRegistered() const
+            {
+                return (m_isRegistered.load(std::memory_order_acquire));
+            }
+            void Unregistered()
+            {
+                m_isRegistered.store(false, std::memory_order_release);
+            }
+
+        private:
+            INTERFACE* const m_sink;
+            std::atomic<bool> m_isRegistered;
+        };
+
+        typedef std::vector<std::shared_ptr<Entry>> Entries;
+
+    public:
+        CopyOnWriteRegistry(const CopyOnWriteRegistry&) = delete;
+        CopyOnWriteRegistry& operator=(const CopyOnWriteRegistry&) = delete;
+
+        CopyOnWriteRegistry()
+            : m_lock()
+            , m_entries(std::make_shared<const Entries>())
+        {
+        }
+        ~CopyOnWriteRegistry() = default;
+
+    public:
+        // Returns false when the sink is registered already
+        bool Register(INTERFACE* sink)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            const bool isNew = (Find(*m_entries, sink) == m_entries->end());
+            if (isNew == true) {
+                std::shared_ptr<Entries> entries = std::make_shared<Entries>(*m_entries);
+                entries->push_back(std::make_shared<Entry>(sink));
+                std::atomic_store(&m_entries, std::shared_ptr<const Entries>(std::move(entries)));
+            }
+
+            return (isNew);
+        }
+
+        // Returns false when the sink is not registered
+        bool Unregister(const INTERFACE* sink)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            auto item = Find(*m_entries, sink);
+            const bool isFound = (item != m_entries->end());
+            if (isFound == true) {
+                (*item)->Unregistered();
+                std::shared_ptr<Entries> entries = std::make_shared<Entries>(*m_entries);
+                entries->erase(entries->begin() + (item - m_entries->begin()));
+                std::atomic_store(&m_entries, std::shared_ptr<const Entries>(std::move(entries)));
+            }
+
+            return (isFound);
+        }
+
+        bool IsEmpty() const
+        {
+            return (std::atomic_load(&m_entries)->empty());
+        }
+
+        // Calls action(INTERFACE*) for every sink that is still registered, without holding a lock
+        template <typename ACTION>
+        void ForEach(ACTION&& action) const
+        {
+            const std::shared_ptr<const Entries> entries = std::atomic_load(&m_entries);
+            for (const std::shared_ptr<Entry>& entry : *entries) {
+                if (entry->IsRegistered() == true) {
+                    action(entry->Sink());
+                }
+            }
+        }
+
+    private:
+        static typename Entries::const_iterator Find(const Entries& entries, const INTERFACE* sink)
+        {
+            return (std::find_if(entries.begin(), entries.end(), [sink](const std::shared_ptr<Entry>& entry) { return (entry->Sink() == sink); }));
+        }
+
+    private:
+        // Replaced as a whole under m_lock, read without a lock by ForEach()
+        mutable std::mutex m_lock;
+        std::shared_ptr<const Entries> m_entries;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
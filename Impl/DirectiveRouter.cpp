@@ -0,0 +1,157 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DirectiveRouter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    constexpr size_t DirectiveRouter::HEADER_SCAN_LIMIT;
+
+    namespace {
+
+        // {"directive":{"header":{...}}} is three levels deep
+        constexpr size_t MAX_DEPTH = 8;
+
+        enum class Frame : uint8_t {
+            OBJECT,
+            ARRAY,
+            DIRECTIVE,
+            HEADER
+        };
+
+        bool Is(const char key[], const size_t length, const char name[])
+        {
+            return ((key != nullptr) && (::strlen(name) == length) && (::strncmp(key, name, length) == 0));
+        }
+
+    } // namespace
+
+    bool DirectiveRouter::Parse(const std::string& message, Header& header)
+    {
+        const char* const text = message.c_str();
+        const size_t length = std::min(message.length(), HEADER_SCAN_LIMIT);
+        Frame frames[MAX_DEPTH];
+        size_t depth = 0;
+        // The last key of the innermost object, and whether the next string is a key
+        const char* key = nullptr;
+        size_t keyLength = 0;
+        bool isKey = false;
+
+        header.nameSpace.clear();
+        header.name.clear();
+
+        for (size_t index = 0; index < length; index++) {
+            switch (text[index]) {
+            case '"': {
+                const size_t start = index + 1;
+                for (index = start; (index < length) && (text[index] != '"'); index++) {
+                    if (text[index] == '\\') {
+                        index++;
+                    }
+                }
+                if (index >= length) {
+                    return false;
+                }
+                if (isKey == true) {
+                    key = &text[start];
+                    keyLength = index - start;
+                    isKey = false;
+                } else if ((depth > 0) && (frames[depth - 1] == Frame::HEADER)) {
+                    if (Is(key, keyLength, "namespace") == true) {
+                        header.nameSpace.assign(&text[start], index - start);
+                    } else if (Is(key, keyLength, "name") == true) {
+                        header.name.assign(&text[start], index - start);
+                    }
+                }
+                break;
+            }
+            case '{':
+            case '[': {
+                if (depth == MAX_DEPTH) {
+                    return false;
+                }
+                Frame frame = ((text[index] == '{') ? Frame::OBJECT : Frame::ARRAY);
+                if ((frame == Frame::OBJECT) && (depth == 1) && (Is(key, keyLength, "directive") == true)) {
+                    frame = Frame::DIRECTIVE;
+                } else if ((frame == Frame::OBJECT) && (depth == 2) && (frames[1] == Frame::DIRECTIVE) && (Is(key, keyLength, "header") == true)) {
+                    frame = Frame::HEADER;
+                }
+                frames[depth++] = frame;
+                isKey = (frame != Frame::ARRAY);
+                key = nullptr;
+                break;
+            }
+            case '}':
+            case ']':
+                if (depth == 0) {
+                    return false;
+                }
+                if (frames[depth - 1] == Frame::HEADER) {
+                    // The rest of the message does not matter
+                    return ((header.nameSpace.empty() == false) && (header.name.empty() == false));
+                }
+                depth--;
+                break;
+            case ',':
+                isKey = ((depth > 0) && (frames[depth - 1] != Frame::ARRAY));
+                break;
+            default:
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    void DirectiveRouter::Subscribe(const std::string& nameSpace, const std::string& name, Handler&& handler)
+    {
+        m_handlers[Key(nameSpace, name)].push_back(std::move(handler));
+    }
+
+    uint32_t DirectiveRouter::Route(const std::string& message) const
+    {
+        uint32_t handled = 0;
+        Header header;
+
+        if ((m_handlers.empty() == false) && (Parse(message, header) == true)) {
+            for (const std::string& key : { Key(header.nameSpace, header.name), Key(header.nameSpace, std::string()) }) {
+                const auto entry = m_handlers.find(key);
+                if (entry != m_handlers.end()) {
+                    for (const Handler& handler : entry->second) {
+                        handler(message);
+                        handled++;
+                    }
+                }
+            }
+        }
+
+        return (handled);
+    }
+
+    std::string DirectiveRouter::Key(const std::string& nameSpace, const std::string& name)
+    {
+        return (nameSpace + '.' + name);
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
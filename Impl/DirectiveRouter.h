@@ -0,0 +1,74 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Hands the AVS directives a MessageObserver receives to the handlers subscribed to them.
+     *
+     * A directive is routed by the namespace and name in its header. Parse() reads them in a
+     * single pass from the start of the message that ends with the header object, and gives up
+     * when the header does not end within HEADER_SCAN_LIMIT characters. The payload after it is
+     * never looked at, however large it is.
+     *
+     * Subscribe() is not thread safe, subscribe all handlers before the router is used.
+     */
+    class DirectiveRouter {
+    public:
+        struct Header {
+            std::string nameSpace;
+            std::string name;
+        };
+
+        typedef std::function<void(const std::string& message)> Handler;
+
+        // AVS sends the header first, it is a few hundred characters at most
+        static constexpr size_t HEADER_SCAN_LIMIT = 2048;
+
+        DirectiveRouter(const DirectiveRouter&) = delete;
+        DirectiveRouter& operator=(const DirectiveRouter&) = delete;
+
+        DirectiveRouter() = default;
+        ~DirectiveRouter() = default;
+
+    public:
+        static bool Parse(const std::string& message, Header& header);
+
+        // An empty name subscribes to all directives of the namespace
+        void Subscribe(const std::string& nameSpace, const std::string& name, Handler&& handler);
+        // Returns the number of handlers the message was handed to
+        uint32_t Route(const std::string& message) const;
+
+    private:
+        static std::string Key(const std::string& nameSpace, const std::string& name);
+
+    private:
+        std::unordered_map<std::string, std::vector<Handler>> m_handlers;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,116 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Voice activity from the signal level alone.
+     *
+     * The noise floor follows the level down immediately and creeps up slowly, so a steady
+     * background becomes the floor. Activity starts when the level has been margin dB above the
+     * floor for onset blocks in a row and lasts until hangover blocks after it dropped.
+     */
+    class EnergyDetector {
+    public:
+        EnergyDetector(const float margin, const uint32_t onset, const uint32_t hangover)
+            : m_margin{ margin }
+            , m_onset{ onset }
+            , m_hangover{ hangover }
+            , m_level{ 0.0f }
+            , m_floor{ std::numeric_limits<float>::max() }
+            , m_loud{ 0 }
+            , m_remaining{ 0 }
+        {
+        }
+
+        ~EnergyDetector() = default;
+
+    public:
+        void Reset()
+        {
+            m_floor = std::numeric_limits<float>::max();
+            m_loud = 0;
+            m_remaining = 0;
+        }
+
+        // Level of the block in dB
+        static float Level(const int16_t samples[], const size_t count)
+        {
+            float power = 0.0f;
+            for (size_t n = 0; n < count; n++) {
+                power += static_cast<float>(samples[n]) * samples[n];
+            }
+            return (10.0f * std::log10((power / count) + 1.0f));
+        }
+
+        // Returns true while there is activity
+        bool Process(const int16_t samples[], const size_t count)
+        {
+            return (Process(Level(samples, count)));
+        }
+        bool Process(const float level)
+        {
+            m_level = level;
+            m_floor = (level < m_floor) ? level : (m_floor + FLOOR_RISE);
+
+            if (level > (m_floor + m_margin)) {
+                if (++m_loud >= m_onset) {
+                    m_remaining = m_hangover;
+                }
+            } else {
+                m_loud = 0;
+                if (m_remaining > 0) {
+                    m_remaining--;
+                }
+            }
+            return (m_remaining > 0);
+        }
+
+        bool IsActive() const
+        {
+            return (m_remaining > 0);
+        }
+        float Level() const
+        {
+            return (m_level);
+        }
+
+    private:
+        // dB per block the noise floor creeps up
+        static constexpr float FLOOR_RISE = 0.02f;
+
+        const float m_margin;
+        const uint32_t m_onset;
+        const uint32_t m_hangover;
+        float m_level;
+        float m_floor;
+        uint32_t m_loud;
+        uint32_t m_remaining;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,164 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    constexpr char FlightRecorder::MAGIC[4];
+    constexpr uint16_t FlightRecorder::VERSION;
+    constexpr size_t FlightRecorder::FILE_HEADER_SIZE;
+    constexpr size_t FlightRecorder::RECORD_HEADER_SIZE;
+    constexpr uint16_t FlightRecorder::NO_ID;
+    constexpr uint8_t FlightRecorder::FLAG_TRUNCATED;
+    constexpr size_t FlightRecorder::MAX_MONIKERS;
+    constexpr size_t FlightRecorder::MAX_FORMATS;
+
+    FlightRecorder::FlightRecorder(const size_t size)
+        : m_size(size)
+        , m_buffer(new uint8_t[size])
+        , m_tail(0)
+        , m_head(0)
+        , m_monikers(MAX_MONIKERS)
+        , m_formats(MAX_FORMATS)
+    {
+    }
+
+    void FlightRecorder::Record(const uint64_t time, const char level, const char moniker[], const char text[], const size_t length, const bool isTruncated)
+    {
+        // SDK lines are "source:event:key=value,...", everything up to the arguments is the format
+        const char* colon = static_cast<const char*>(::memchr(text, ':', length));
+        if (colon != nullptr) {
+            colon = static_cast<const char*>(::memchr(colon + 1, ':', length - (colon + 1 - text)));
+        }
+        const size_t formatLength = (colon != nullptr) ? static_cast<size_t>(colon + 1 - text) : 0;
+
+        const uint16_t monikerId = m_monikers.Id(moniker, ::strlen(moniker));
+        const uint16_t formatId = (colon != nullptr) ? m_formats.Id(text, formatLength) : NO_ID;
+        const char* arguments = (formatId == NO_ID) ? text : (text + formatLength);
+        size_t argumentsLength = (formatId == NO_ID) ? length : (length - formatLength);
+
+        argumentsLength = std::min(argumentsLength, static_cast<size_t>(UINT16_MAX) - RECORD_HEADER_SIZE);
+        if ((RECORD_HEADER_SIZE + argumentsLength) > m_size) {
+            return;
+        }
+        const size_t size = RECORD_HEADER_SIZE + argumentsLength;
+
+        // Make room by dropping the oldest records
+        while ((m_head - m_tail + size) > m_size) {
+            uint8_t recordSize[2];
+            Read(m_tail, recordSize, sizeof(recordSize));
+            m_tail += Get16(recordSize);
+        }
+
+        uint8_t header[RECORD_HEADER_SIZE];
+        Put16(&header[0], static_cast<uint16_t>(size));
+        header[2] = static_cast<uint8_t>(level);
+        header[3] = (isTruncated == true) ? FLAG_TRUNCATED : 0;
+        Put16(&header[4], monikerId);
+        Put16(&header[6], formatId);
+        Put64(&header[8], time);
+
+        Write(m_head, header, sizeof(header));
+        Write(m_head + sizeof(header), reinterpret_cast<const uint8_t*>(arguments), argumentsLength);
+        m_head += size;
+    }
+
+    bool FlightRecorder::Dump(const std::string& path, const uint64_t time) const
+    {
+        std::vector<uint8_t> output(FILE_HEADER_SIZE);
+        ::memcpy(output.data(), MAGIC, sizeof(MAGIC));
+        Put16(&output[4], VERSION);
+        Put64(&output[6], time);
+
+        m_monikers.Write(output);
+        m_formats.Write(output);
+
+        const size_t used = m_head - m_tail;
+        const size_t offset = output.size();
+        output.resize(offset + 4 + used);
+        Put32(&output[offset], static_cast<uint32_t>(used));
+        if (used > 0) {
+            Read(m_tail, &output[offset + 4], used);
+        }
+
+        // Written aside and renamed, so a dump is never seen half written
+        const std::string temporary = path + ".tmp";
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(output.data()), output.size());
+        file.close();
+
+        return ((file.good() == true) && (::rename(temporary.c_str(), path.c_str()) == 0));
+    }
+
+    uint16_t FlightRecorder::Dictionary::Id(const char text[], const size_t length)
+    {
+        uint16_t id = NO_ID;
+        const std::string key(text, std::min(length, static_cast<size_t>(UINT16_MAX)));
+
+        auto entry = m_ids.find(key);
+        if (entry != m_ids.end()) {
+            id = entry->second;
+        } else if (m_entries.size() < m_maximum) {
+            id = static_cast<uint16_t>(m_entries.size());
+            m_ids.emplace(key, id);
+            m_entries.push_back(key);
+        }
+
+        return (id);
+    }
+
+    void FlightRecorder::Dictionary::Write(std::vector<uint8_t>& output) const
+    {
+        size_t offset = output.size();
+        output.resize(offset + 2);
+        Put16(&output[offset], static_cast<uint16_t>(m_entries.size()));
+
+        for (const std::string& entry : m_entries) {
+            offset = output.size();
+            output.resize(offset + 2 + entry.length());
+            Put16(&output[offset], static_cast<uint16_t>(entry.length()));
+            ::memcpy(&output[offset + 2], entry.data(), entry.length());
+        }
+    }
+
+    void FlightRecorder::Write(const size_t position, const uint8_t data[], const size_t length)
+    {
+        const size_t offset = position % m_size;
+        const size_t first = std::min(length, m_size - offset);
+        ::memcpy(&m_buffer[offset], data, first);
+        ::memcpy(&m_buffer[0], &data[first], length - first);
+    }
+
+    void FlightRecorder::Read(const size_t position, uint8_t data[], const size_t length) const
+    {
+        const size_t offset = position % m_size;
+        const size_t first = std::min(length, m_size - offset);
+        ::memcpy(data, &m_buffer[offset], first);
+        ::memcpy(&data[first], &m_buffer[0], length - first);
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,146 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Fixed-size in-memory ring of binary log records, overwriting the oldest.
+     *
+     * A record keeps the time, the level, the thread moniker and the text of an AVS SDK log line.
+     * Monikers and the "source:event:" start of the text, the format, are kept once in a
+     * dictionary and referred to by id, only the rest of the text, the arguments, is stored per
+     * record. Dump() writes the dictionary and the records to a file, which the AVSLogDecoder
+     * tool turns back into text.
+     *
+     * Dump file, all numbers little endian:
+     *   magic "AVFR", version (16 bit), dump time (64 bit, microseconds since the epoch)
+     *   moniker count (16 bit), then per moniker its length (16 bit) and characters
+     *   format count (16 bit), then per format its length (16 bit) and characters
+     *   size of the records (32 bit), then the records from the oldest to the newest
+     * Record:
+     *   size of the record (16 bit), level character, flags, moniker id (16 bit),
+     *   format id (16 bit), time (64 bit, microseconds since the epoch), arguments
+     *
+     * Not thread safe, the ThunderLogger thread is its only user.
+     */
+    class FlightRecorder {
+    public:
+        static constexpr char MAGIC[4] = { 'A', 'V', 'F', 'R' };
+        static constexpr uint16_t VERSION = 1;
+        static constexpr size_t FILE_HEADER_SIZE = 14;
+        static constexpr size_t RECORD_HEADER_SIZE = 16;
+        // Moniker or format not in the dictionary, the record holds the whole text as arguments
+        static constexpr uint16_t NO_ID = 0xFFFF;
+        static constexpr uint8_t FLAG_TRUNCATED = 0x01;
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        explicit FlightRecorder(const size_t size);
+        ~FlightRecorder() = default;
+
+    public:
+        void Record(const uint64_t time, const char level, const char moniker[], const char text[], const size_t length, const bool isTruncated);
+        bool Dump(const std::string& path, const uint64_t time) const;
+
+        size_t Size() const
+        {
+            return (m_size);
+        }
+
+        static void Put16(uint8_t buffer[], const uint16_t value)
+        {
+            buffer[0] = static_cast<uint8_t>(value);
+            buffer[1] = static_cast<uint8_t>(value >> 8);
+        }
+        static uint16_t Get16(const uint8_t buffer[])
+        {
+            return (static_cast<uint16_t>(buffer[0] | (buffer[1] << 8)));
+        }
+        static void Put32(uint8_t buffer[], const uint32_t value)
+        {
+            Put16(buffer, static_cast<uint16_t>(value));
+            Put16(&buffer[2], static_cast<uint16_t>(value >> 16));
+        }
+        static uint32_t Get32(const uint8_t buffer[])
+        {
+            return (Get16(buffer) | (static_cast<uint32_t>(Get16(&buffer[2])) << 16));
+        }
+        static void Put64(uint8_t buffer[], const uint64_t value)
+        {
+            Put32(buffer, static_cast<uint32_t>(value));
+            Put32(&buffer[4], static_cast<uint32_t>(value >> 32));
+        }
+        static uint64_t Get64(const uint8_t buffer[])
+        {
+            return (Get32(buffer) | (static_cast<uint64_t>(Get32(&buffer[4])) << 32));
+        }
+
+    private:
+        // Bounds the dictionary, should the SDK log lines without a format
+        static constexpr size_t MAX_MONIKERS = 1024;
+        static constexpr size_t MAX_FORMATS = 4096;
+
+        class Dictionary {
+        public:
+            Dictionary(const Dictionary&) = delete;
+            Dictionary& operator=(const Dictionary&) = delete;
+
+            explicit Dictionary(const size_t maximum)
+                : m_maximum(maximum)
+                , m_ids()
+                , m_entries()
+            {
+            }
+            ~Dictionary() = default;
+
+        public:
+            uint16_t Id(const char text[], const size_t length);
+            void Write(std::vector<uint8_t>& output) const;
+
+        private:
+            const size_t m_maximum;
+            std::unordered_map<std::string, uint16_t> m_ids;
+            std::vector<std::string> m_entries;
+        };
+
+        void Write(const size_t position, const uint8_t data[], const size_t length);
+        void Read(const size_t position, uint8_t data[], const size_t length) const;
+
+    private:
+        const size_t m_size;
+        std::unique_ptr<uint8_t[]> m_buffer;
+        // Monotonic byte positions of the oldest record and the end of the newest
+        size_t m_tail;
+        size_t m_head;
+        Dictionary m_monikers;
+        Dictionary m_formats;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,279 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HttpDispatcher.h"
+#include "TraceCategories.h"
+
+#include <curl/curl.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    namespace {
+
+        // Longest the thread sleeps in libcurl, a post wakes it up through the pipe right away
+        constexpr int IDLE_WAIT = 1000;
+
+        size_t Discard(char*, size_t size, size_t count, void*)
+        {
+            return (size * count);
+        }
+
+        // Only a post the endpoint cannot have acted on is sent again, the documents are not idempotent
+        bool IsRetriable(const CURLcode result, const long status, const long sent)
+        {
+            bool retriable = false;
+            if (result != CURLE_OK) {
+                retriable = ((result == CURLE_COULDNT_RESOLVE_HOST) || (result == CURLE_COULDNT_RESOLVE_PROXY) || (result == CURLE_COULDNT_CONNECT) || (sent == 0));
+            } else {
+                retriable = (status == 503);
+            }
+            return (retriable);
+        }
+
+    } // namespace
+
+    HttpDispatcher::HttpDispatcher(const Settings& settings)
+        : m_settings(settings)
+        , m_isValid(false)
+        , m_wakeup{ -1, -1 }
+        , m_lock()
+        , m_idle()
+        , m_requests()
+        , m_inFlight(0)
+        , m_isRunning(true)
+        , m_statistics()
+        , m_totalLatency(0)
+        , m_thread()
+    {
+        if (m_settings.endpoint.empty() == true) {
+            TRACE(AVSClient, (_T("No endpoint to post to")));
+        } else if (::pipe2(m_wakeup, O_NONBLOCK | O_CLOEXEC) != 0) {
+            TRACE(AVSClient, (_T("Failed to create the wake-up pipe of the HTTP dispatcher")));
+        } else {
+            m_isValid = true;
+            m_thread = std::thread(&HttpDispatcher::Worker, this);
+        }
+    }
+
+    HttpDispatcher::~HttpDispatcher()
+    {
+        size_t discarded = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_isRunning = false;
+            discarded = m_requests.size();
+            m_requests.clear();
+        }
+        if (m_thread.joinable() == true) {
+            Wake();
+            m_thread.join();
+        }
+        for (const int descriptor : m_wakeup) {
+            if (descriptor != -1) {
+                ::close(descriptor);
+            }
+        }
+        if (discarded > 0) {
+            TRACE(AVSClient, (_T("Discarded %zu queued posts to %s"), discarded, m_settings.endpoint.c_str()));
+        }
+    }
+
+    bool HttpDispatcher::Post(const std::string& document)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if ((m_isValid == false) || (m_isRunning == false)) {
+                return false;
+            }
+
+            m_statistics.posts++;
+            if (std::any_of(m_requests.begin(), m_requests.end(), [&document](const Request& request) { return (request.document == document); }) == true) {
+                m_statistics.coalesced++;
+                return true;
+            }
+            if (m_requests.size() >= m_settings.queue) {
+                m_statistics.dropped++;
+                return false;
+            }
+            m_requests.push_back({ document, std::chrono::steady_clock::now(), 0 });
+        }
+
+        Wake();
+        return true;
+    }
+
+    bool HttpDispatcher::Flush(const std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        return (m_idle.wait_for(lock, timeout, [this]() { return ((m_requests.empty() == true) && (m_inFlight == 0)); }));
+    }
+
+    HttpDispatcher::Statistics HttpDispatcher::Counters() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        Statistics statistics = m_statistics;
+        statistics.averageLatency = (m_statistics.sent > 0) ? (m_totalLatency / m_statistics.sent) : 0;
+        return (statistics);
+    }
+
+    void HttpDispatcher::Wake()
+    {
+        const char signal = 0;
+        // A full pipe wakes the thread just as well
+        ssize_t written = ::write(m_wakeup[1], &signal, sizeof(signal));
+        (void)written;
+    }
+
+    void HttpDispatcher::Worker()
+    {
+        struct Transfer {
+            CURL* easy;
+            Request request;
+            bool isBusy;
+        };
+
+        CURLM* multi = curl_multi_init();
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(m_settings.connections));
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, static_cast<long>(m_settings.connections));
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+        curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+
+        // The easy handles are reused as well, the connections are in the cache of the multi handle
+        std::vector<Transfer> transfers(m_settings.connections);
+        for (Transfer& transfer : transfers) {
+            transfer.easy = curl_easy_init();
+            transfer.isBusy = false;
+            curl_easy_setopt(transfer.easy, CURLOPT_URL, m_settings.endpoint.c_str());
+            curl_easy_setopt(transfer.easy, CURLOPT_POST, 1L);
+            curl_easy_setopt(transfer.easy, CURLOPT_HTTPHEADER, headers);
+            curl_easy_setopt(transfer.easy, CURLOPT_TIMEOUT_MS, static_cast<long>(m_settings.timeout.count()));
+            curl_easy_setopt(transfer.easy, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(transfer.easy, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(transfer.easy, CURLOPT_WRITEFUNCTION, Discard);
+            curl_easy_setopt(transfer.easy, CURLOPT_PRIVATE, &transfer);
+        }
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (m_isRunning == true) {
+            for (Transfer& transfer : transfers) {
+                if ((transfer.isBusy == false) && (m_requests.empty() == false)) {
+                    transfer.request = std::move(m_requests.front());
+                    m_requests.pop_front();
+                    transfer.isBusy = true;
+                    m_inFlight++;
+                    curl_easy_setopt(transfer.easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer.request.document.size()));
+                    curl_easy_setopt(transfer.easy, CURLOPT_POSTFIELDS, transfer.request.document.c_str());
+                    curl_multi_add_handle(multi, transfer.easy);
+                }
+            }
+            lock.unlock();
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+
+            bool isCompleted = false;
+            int left = 0;
+            const CURLMsg* message;
+            while ((message = curl_multi_info_read(multi, &left)) != nullptr) {
+                if (message->msg != CURLMSG_DONE) {
+                    continue;
+                }
+
+                Transfer* transfer = nullptr;
+                long status = 0;
+                long connects = 0;
+                long sent = 0;
+                curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+                curl_easy_getinfo(message->easy_handle, CURLINFO_RESPONSE_CODE, &status);
+                curl_easy_getinfo(message->easy_handle, CURLINFO_NUM_CONNECTS, &connects);
+                curl_easy_getinfo(message->easy_handle, CURLINFO_REQUEST_SIZE, &sent);
+                const CURLcode result = message->data.result;
+                curl_multi_remove_handle(multi, transfer->easy);
+                isCompleted = true;
+
+                const bool isRetriable = IsRetriable(result, status, sent);
+                const bool isFailed = ((result != CURLE_OK) || (status >= 400));
+
+                bool isGivenUp = false;
+
+                lock.lock();
+                m_statistics.connects += connects;
+                if ((isRetriable == true) && (transfer->request.attempts < m_settings.retries) && (m_isRunning == true)) {
+                    transfer->request.attempts++;
+                    m_statistics.retried++;
+                    m_requests.push_front(std::move(transfer->request));
+                } else if (isFailed == true) {
+                    m_statistics.failed++;
+                    isGivenUp = true;
+                } else {
+                    const uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - transfer->request.posted).count();
+                    m_statistics.sent++;
+                    m_statistics.maxLatency = std::max(m_statistics.maxLatency, latency);
+                    m_totalLatency += latency;
+                }
+                transfer->isBusy = false;
+                m_inFlight--;
+                if ((m_inFlight == 0) && (m_requests.empty() == true)) {
+                    m_idle.notify_all();
+                }
+                lock.unlock();
+
+                if (isGivenUp == true) {
+                    TRACE(AVSClient, (_T("Post to %s failed: %s, status %ld"), m_settings.endpoint.c_str(), curl_easy_strerror(result), status));
+                }
+            }
+
+            // A transfer that completed makes room for a queued post, start it right away
+            if (isCompleted == false) {
+                curl_waitfd wakeup = { m_wakeup[0], CURL_WAIT_POLLIN, 0 };
+                curl_multi_wait(multi, &wakeup, 1, IDLE_WAIT, nullptr);
+                if ((wakeup.revents & POLLIN) != 0) {
+                    char signals[64];
+                    while (::read(m_wakeup[0], signals, sizeof(signals)) > 0) {
+                    }
+                }
+            }
+
+            lock.lock();
+        }
+        lock.unlock();
+
+        for (Transfer& transfer : transfers) {
+            if (transfer.isBusy == true) {
+                curl_multi_remove_handle(multi, transfer.easy);
+            }
+            curl_easy_cleanup(transfer.easy);
+        }
+        curl_slist_free_all(headers);
+        curl_multi_cleanup(multi);
+
+        m_idle.notify_all();
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,171 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Posts JSON documents to an HTTP endpoint over connections that are kept open.
+     *
+     * Post() queues the document and returns, a thread of the dispatcher sends it. Up to
+     * Settings::connections posts are in flight at once, each on a connection of the pool
+     * libcurl keeps alive between the posts, or all multiplexed on one when the endpoint
+     * speaks HTTP/2. A document equal to one still waiting to be sent is not queued again,
+     * so a burst of the same post is sent once. A post that failed before any of it was sent,
+     * like one that could not connect, or that got a 503 response is sent again, at most
+     * Settings::retries times. Others may have been acted on already and are not repeated.
+     */
+    class HttpDispatcher {
+    public:
+        struct Settings {
+            Settings()
+                : endpoint()
+                , connections{ 2 }
+                , timeout{ 2000 }
+                , retries{ 1 }
+                , queue{ 32 }
+            {
+            }
+
+            std::string endpoint;
+            uint32_t connections;
+            // Per attempt, including the connection setup
+            std::chrono::milliseconds timeout;
+            uint32_t retries;
+            // Posts waiting to be sent, more are dropped
+            uint32_t queue;
+        };
+
+        struct Statistics {
+            uint64_t posts;
+            uint64_t coalesced;
+            uint64_t dropped;
+            uint64_t sent;
+            uint64_t retried;
+            uint64_t failed;
+            uint64_t connects;
+            // Of the posts sent, from Post() to the response, in microseconds
+            uint64_t averageLatency;
+            uint64_t maxLatency;
+        };
+
+        HttpDispatcher(const HttpDispatcher&) = delete;
+        HttpDispatcher& operator=(const HttpDispatcher&) = delete;
+
+        explicit HttpDispatcher(const Settings& settings);
+        ~HttpDispatcher();
+
+    public:
+        bool IsValid() const
+        {
+            return (m_isValid);
+        }
+
+        // Never blocks, false when the post was dropped
+        bool Post(const std::string& document);
+        // Waits until nothing is queued or in flight
+        bool Flush(const std::chrono::milliseconds timeout);
+        Statistics Counters() const;
+
+    private:
+        struct Request {
+            std::string document;
+            std::chrono::steady_clock::time_point posted;
+            uint32_t attempts;
+        };
+
+        void Worker();
+        void Wake();
+
+    private:
+        const Settings m_settings;
+        bool m_isValid;
+        int m_wakeup[2];
+
+        mutable std::mutex m_lock;
+        std::condition_variable m_idle;
+        std::deque<Request> m_requests;
+        uint32_t m_inFlight;
+        bool m_isRunning;
+        Statistics m_statistics;
+        uint64_t m_totalLatency;
+
+        std::thread m_thread;
+    };
+
+    class HttpDispatcherConfig : public Core::JSON::Container {
+    public:
+        HttpDispatcherConfig(const HttpDispatcherConfig&) = delete;
+        HttpDispatcherConfig& operator=(const HttpDispatcherConfig&) = delete;
+
+    public:
+        HttpDispatcherConfig()
+            : Core::JSON::Container()
+            , Endpoint()
+            , Connections()
+            , Timeout()
+            , Retries()
+        {
+            Add(_T("endpoint"), &Endpoint);
+            Add(_T("connections"), &Connections);
+            Add(_T("timeout"), &Timeout);
+            Add(_T("retries"), &Retries);
+        }
+
+        ~HttpDispatcherConfig() override = default;
+
+        // Fills in the settings, leaving what is not configured at its default
+        bool Get(HttpDispatcher::Settings& settings) const
+        {
+            if (Endpoint.IsSet() == true) {
+                settings.endpoint = Endpoint.Value();
+            }
+            if (Connections.IsSet() == true) {
+                settings.connections = Connections.Value();
+            }
+            if (Timeout.IsSet() == true) {
+                settings.timeout = std::chrono::milliseconds(Timeout.Value());
+            }
+            if (Retries.IsSet() == true) {
+                settings.retries = Retries.Value();
+            }
+            return ((settings.connections > 0) && (settings.connections <= 16) && (settings.timeout.count() > 0));
+        }
+
+    public:
+        Core::JSON::String Endpoint;
+        Core::JSON::DecUInt32 Connections;
+        Core::JSON::DecUInt32 Timeout;
+        Core::JSON::DecUInt32 Retries;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,385 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Plugin private diagnostics of the AVS implementation, published by the AVS plugin
+     * next to the AVSController JSON-RPC methods.
+     *
+     * The interface has no proxy/stub, so it is only reachable when the implementation runs
+     * in the plugin's process. Data is exchanged as JSON documents described below.
+     */
+    struct IAVSDiagnostics : virtual public Core::IUnknown {
+        enum { ID = RPC::ID_EXTERNAL_INTERFACE_OFFSET + 0xA500 };
+
+        ~IAVSDiagnostics() override = default;
+
+        // Voice input statistics of the last completed utterance (VoiceStatistics)
+        virtual uint32_t VoiceStatistics(string& statistics /* @out */) const = 0;
+        // Memory used by the audio input path (MemoryStatistics)
+        virtual uint32_t MemoryStatistics(string& statistics /* @out */) const = 0;
+        // Keyword detection counters since the detector started (KeywordStatistics)
+        virtual uint32_t KeywordStatistics(string& statistics /* @out */) const = 0;
+        // Counters of the asynchronous AVS SDK log sink (LogStatistics)
+        virtual uint32_t LogStatistics(string& statistics /* @out */) const = 0;
+        // Writes the flight recorder of the AVS SDK logs to a file in the persistent path
+        virtual uint32_t DumpLog(string& path /* @out */) = 0;
+        // Queue between the AVS SDK observer callbacks and VoiceToApps (ObserverStatistics)
+        virtual uint32_t ObserverStatistics(string& statistics /* @out */) const = 0;
+        // Trace level of an AVS SDK component, the general one without a component (LogLevel)
+        virtual uint32_t LogLevel(const string& component, string& level /* @out */) const = 0;
+        // An empty level gives the component the general trace level again
+        virtual uint32_t SetLogLevel(const string& component, const string& level) = 0;
+    };
+
+    namespace Diagnostics {
+
+        class VoiceStatistics : public Core::JSON::Container {
+        public:
+            VoiceStatistics(const VoiceStatistics&) = delete;
+            VoiceStatistics& operator=(const VoiceStatistics&) = delete;
+
+        public:
+            VoiceStatistics()
+                : Core::JSON::Container()
+                , Received()
+                , Lost()
+                , Late()
+                , Discontinuities()
+                , Concealment()
+                , RingDropped()
+                , RingHighWaterMark()
+                , InputRate()
+                , InputChannels()
+                , ConversionCost()
+                , Codec()
+                , DecodingCost()
+                , PreRoll()
+            {
+                Add(_T("received"), &Received);
+                Add(_T("lost"), &Lost);
+                Add(_T("late"), &Late);
+                Add(_T("discontinuities"), &Discontinuities);
+                Add(_T("concealment"), &Concealment);
+                Add(_T("ringdropped"), &RingDropped);
+                Add(_T("ringhighwatermark"), &RingHighWaterMark);
+                Add(_T("inputrate"), &InputRate);
+                Add(_T("inputchannels"), &InputChannels);
+                Add(_T("conversioncost"), &ConversionCost);
+                Add(_T("codec"), &Codec);
+                Add(_T("decodingcost"), &DecodingCost);
+                Add(_T("preroll"), &PreRoll);
+            }
+
+            ~VoiceStatistics() override = default;
+
+        public:
+            Core::JSON::DecUInt64 Received;
+            Core::JSON::DecUInt64 Lost;
+            Core::JSON::DecUInt64 Late;
+            Core::JSON::DecUInt64 Discontinuities;
+            Core::JSON::String Concealment;
+            Core::JSON::DecUInt64 RingDropped;
+            Core::JSON::DecUInt64 RingHighWaterMark;
+            Core::JSON::DecUInt32 InputRate;
+            Core::JSON::DecUInt8 InputChannels;
+            Core::JSON::DecUInt32 ConversionCost;
+            Core::JSON::String Codec;
+            Core::JSON::DecUInt32 DecodingCost;
+            Core::JSON::DecUInt32 PreRoll;
+        };
+
+        class MemoryStatistics : public Core::JSON::Container {
+        public:
+            MemoryStatistics(const MemoryStatistics&) = delete;
+            MemoryStatistics& operator=(const MemoryStatistics&) = delete;
+
+        public:
+            MemoryStatistics()
+                : Core::JSON::Container()
+                , Readers()
+                , WordSize()
+                , Duration()
+                , BufferSize()
+                , OverheadSize()
+                , HighWaterMark()
+                , Locked()
+                , HugePages()
+                , StagingRingSize()
+                , StagingRingHighWaterMark()
+                , ModelSize()
+                , ModelResident()
+                , DecoderSize()
+            {
+                Add(_T("readers"), &Readers);
+                Add(_T("wordsize"), &WordSize);
+                Add(_T("duration"), &Duration);
+                Add(_T("buffersize"), &BufferSize);
+                Add(_T("overheadsize"), &OverheadSize);
+                Add(_T("highwatermark"), &HighWaterMark);
+                Add(_T("locked"), &Locked);
+                Add(_T("hugepages"), &HugePages);
+                Add(_T("stagingringsize"), &StagingRingSize);
+                Add(_T("stagingringhighwatermark"), &StagingRingHighWaterMark);
+                Add(_T("modelsize"), &ModelSize);
+                Add(_T("modelresident"), &ModelResident);
+                Add(_T("decodersize"), &DecoderSize);
+            }
+
+            ~MemoryStatistics() override = default;
+
+        public:
+            Core::JSON::DecUInt32 Readers;
+            Core::JSON::DecUInt8 WordSize;
+            Core::JSON::DecUInt32 Duration;
+            Core::JSON::DecUInt64 BufferSize;
+            Core::JSON::DecUInt64 OverheadSize;
+            Core::JSON::DecUInt64 HighWaterMark;
+            Core::JSON::Boolean Locked;
+            Core::JSON::Boolean HugePages;
+            Core::JSON::DecUInt64 StagingRingSize;
+            Core::JSON::DecUInt64 StagingRingHighWaterMark;
+            Core::JSON::DecUInt64 ModelSize;
+            Core::JSON::DecUInt64 ModelResident;
+            Core::JSON::DecUInt64 DecoderSize;
+        };
+
+        class KeywordStatistics : public Core::JSON::Container {
+        public:
+            KeywordStatistics(const KeywordStatistics&) = delete;
+            KeywordStatistics& operator=(const KeywordStatistics&) = delete;
+
+        public:
+            KeywordStatistics()
+                : Core::JSON::Container()
+                , Detections()
+                , Audio()
+                , Overruns()
+                , Skipped()
+                , ProcessingCost()
+                , Speech()
+                , IdleCost()
+                , Late()
+                , MaxBacklog()
+                , Gated()
+                , GateOpenings()
+            {
+                Add(_T("detections"), &Detections);
+                Add(_T("audio"), &Audio);
+                Add(_T("overruns"), &Overruns);
+                Add(_T("skipped"), &Skipped);
+                Add(_T("processingcost"), &ProcessingCost);
+                Add(_T("speech"), &Speech);
+                Add(_T("idlecost"), &IdleCost);
+                Add(_T("late"), &Late);
+                Add(_T("maxbacklog"), &MaxBacklog);
+                Add(_T("gated"), &Gated);
+                Add(_T("gateopenings"), &GateOpenings);
+            }
+
+            ~KeywordStatistics() override = default;
+
+        public:
+            Core::JSON::DecUInt64 Detections;
+            Core::JSON::DecUInt64 Audio;
+            Core::JSON::DecUInt64 Overruns;
+            Core::JSON::DecUInt64 Skipped;
+            Core::JSON::DecUInt32 ProcessingCost;
+            Core::JSON::DecUInt64 Speech;
+            Core::JSON::DecUInt32 IdleCost;
+            Core::JSON::DecUInt64 Late;
+            Core::JSON::DecUInt32 MaxBacklog;
+            Core::JSON::DecUInt64 Gated;
+            Core::JSON::DecUInt64 GateOpenings;
+        };
+
+        class LogStatistics : public Core::JSON::Container {
+        public:
+            LogStatistics(const LogStatistics&) = delete;
+            LogStatistics& operator=(const LogStatistics&) = delete;
+
+        public:
+            LogStatistics()
+                : Core::JSON::Container()
+                , Records()
+                , Dropped()
+                , Truncated()
+                , Capacity()
+                , HighWaterMark()
+            {
+                Add(_T("records"), &Records);
+                Add(_T("dropped"), &Dropped);
+                Add(_T("truncated"), &Truncated);
+                Add(_T("capacity"), &Capacity);
+                Add(_T("highwatermark"), &HighWaterMark);
+            }
+
+            ~LogStatistics() override = default;
+
+        public:
+            Core::JSON::DecUInt64 Records;
+            Core::JSON::DecUInt64 Dropped;
+            Core::JSON::DecUInt64 Truncated;
+            Core::JSON::DecUInt32 Capacity;
+            Core::JSON::DecUInt32 HighWaterMark;
+        };
+
+        class CallbackStatistics : public Core::JSON::Container {
+        public:
+            CallbackStatistics(const CallbackStatistics& copy)
+                : Core::JSON::Container()
+                , Callback(copy.Callback)
+                , Calls(copy.Calls)
+                , Dropped(copy.Dropped)
+                , Coalesced(copy.Coalesced)
+                , Wait(copy.Wait)
+                , MaxWait(copy.MaxWait)
+                , Run(copy.Run)
+                , MaxRun(copy.MaxRun)
+            {
+                Init();
+            }
+
+            CallbackStatistics()
+                : Core::JSON::Container()
+                , Callback()
+                , Calls()
+                , Dropped()
+                , Coalesced()
+                , Wait()
+                , MaxWait()
+                , Run()
+                , MaxRun()
+            {
+                Init();
+            }
+
+            ~CallbackStatistics() override = default;
+
+        private:
+            void Init()
+            {
+                Add(_T("callback"), &Callback);
+                Add(_T("calls"), &Calls);
+                Add(_T("dropped"), &Dropped);
+                Add(_T("coalesced"), &Coalesced);
+                Add(_T("wait"), &Wait);
+                Add(_T("maxwait"), &MaxWait);
+                Add(_T("run"), &Run);
+                Add(_T("maxrun"), &MaxRun);
+            }
+
+        public:
+            Core::JSON::String Callback;
+            Core::JSON::DecUInt64 Calls;
+            Core::JSON::DecUInt64 Dropped;
+            Core::JSON::DecUInt64 Coalesced;
+            // Histograms, microseconds up to 100, 1000, 10000, 100000, 1000000 and beyond
+            Core::JSON::ArrayType<Core::JSON::DecUInt64> Wait;
+            Core::JSON::DecUInt32 MaxWait;
+            Core::JSON::ArrayType<Core::JSON::DecUInt64> Run;
+            Core::JSON::DecUInt32 MaxRun;
+        };
+
+        class DispatcherStatistics : public Core::JSON::Container {
+        public:
+            DispatcherStatistics(const DispatcherStatistics&) = delete;
+            DispatcherStatistics& operator=(const DispatcherStatistics&) = delete;
+
+        public:
+            DispatcherStatistics()
+                : Core::JSON::Container()
+                , Posts()
+                , Coalesced()
+                , Dropped()
+                , Sent()
+                , Retried()
+                , Failed()
+                , Connects()
+                , Latency()
+                , MaxLatency()
+            {
+                Add(_T("posts"), &Posts);
+                Add(_T("coalesced"), &Coalesced);
+                Add(_T("dropped"), &Dropped);
+                Add(_T("sent"), &Sent);
+                Add(_T("retried"), &Retried);
+                Add(_T("failed"), &Failed);
+                Add(_T("connects"), &Connects);
+                Add(_T("latency"), &Latency);
+                Add(_T("maxlatency"), &MaxLatency);
+            }
+
+            ~DispatcherStatistics() override = default;
+
+        public:
+            Core::JSON::DecUInt64 Posts;
+            Core::JSON::DecUInt64 Coalesced;
+            Core::JSON::DecUInt64 Dropped;
+            Core::JSON::DecUInt64 Sent;
+            Core::JSON::DecUInt64 Retried;
+            Core::JSON::DecUInt64 Failed;
+            Core::JSON::DecUInt64 Connects;
+            // Microseconds from the post to the response
+            Core::JSON::DecUInt64 Latency;
+            Core::JSON::DecUInt64 MaxLatency;
+        };
+
+        class ObserverStatistics : public Core::JSON::Container {
+        public:
+            ObserverStatistics(const ObserverStatistics&) = delete;
+            ObserverStatistics& operator=(const ObserverStatistics&) = delete;
+
+        public:
+            ObserverStatistics()
+                : Core::JSON::Container()
+                , Capacity()
+                , Depth()
+                , HighWaterMark()
+                , Callbacks()
+                , Dispatcher()
+            {
+                Add(_T("capacity"), &Capacity);
+                Add(_T("depth"), &Depth);
+                Add(_T("highwatermark"), &HighWaterMark);
+                Add(_T("callbacks"), &Callbacks);
+                Add(_T("dispatcher"), &Dispatcher);
+            }
+
+            ~ObserverStatistics() override = default;
+
+        public:
+            Core::JSON::DecUInt32 Capacity;
+            Core::JSON::DecUInt32 Depth;
+            Core::JSON::DecUInt32 HighWaterMark;
+            Core::JSON::ArrayType<CallbackStatistics> Callbacks;
+            // Only when the posts for VoiceToApps go through the HTTP dispatcher
+            DispatcherStatistics Dispatcher;
+        };
+
+    } // namespace Diagnostics
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,111 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Plugin private control of the wake word detector, published by the AVS plugin next to
+     * the AVSController JSON-RPC methods.
+     *
+     * Like IAVSDiagnostics it has no proxy/stub and is only reachable in the plugin's process.
+     */
+    struct IAVSKeywordDetection : virtual public Core::IUnknown {
+        enum { ID = RPC::ID_EXTERNAL_INTERFACE_OFFSET + 0xA501 };
+
+        struct INotification : virtual public Core::IUnknown {
+            enum { ID = RPC::ID_EXTERNAL_INTERFACE_OFFSET + 0xA502 };
+
+            ~INotification() override = default;
+
+            // Voice activity detected by the wake word engine started or stopped
+            virtual void VoiceActivity(const bool active) = 0;
+            // A wake word was detected, confidence is reported by the engine on the scale of the threshold
+            virtual void KeywordDetected(const string& keyword, const uint32_t confidence) = 0;
+        };
+
+        ~IAVSKeywordDetection() override = default;
+
+        virtual void Register(INotification* sink) = 0;
+        virtual void Unregister(const INotification* sink) = 0;
+
+        // Locale of the wake word model, as listed in the localeToModels configuration
+        virtual uint32_t Locale(string& locale /* @out */) const = 0;
+        virtual uint32_t SetLocale(const string& locale) = 0;
+
+        // Wake word reported by the detector, must be one of the model
+        virtual uint32_t Keyword(string& keyword /* @out */) const = 0;
+        virtual uint32_t SetKeyword(const string& keyword) = 0;
+
+        // Detection threshold of a keyword, 1 (most sensitive) to 1000, takes effect without a restart
+        virtual uint32_t Threshold(const string& keyword, uint32_t& threshold /* @out */) const = 0;
+        virtual uint32_t SetThreshold(const string& keyword, const uint32_t threshold) = 0;
+    };
+
+    namespace KeywordDetection {
+
+        class VoiceActivityParams : public Core::JSON::Container {
+        public:
+            VoiceActivityParams(const VoiceActivityParams&) = delete;
+            VoiceActivityParams& operator=(const VoiceActivityParams&) = delete;
+
+        public:
+            VoiceActivityParams()
+                : Core::JSON::Container()
+                , Active()
+            {
+                Add(_T("active"), &Active);
+            }
+
+            ~VoiceActivityParams() override = default;
+
+        public:
+            Core::JSON::Boolean Active;
+        };
+
+        class KeywordDetectedParams : public Core::JSON::Container {
+        public:
+            KeywordDetectedParams(const KeywordDetectedParams&) = delete;
+            KeywordDetectedParams& operator=(const KeywordDetectedParams&) = delete;
+
+        public:
+            KeywordDetectedParams()
+                : Core::JSON::Container()
+                , Keyword()
+                , Confidence()
+            {
+                Add(_T("keyword"), &Keyword);
+                Add(_T("confidence"), &Confidence);
+            }
+
+            ~KeywordDetectedParams() override = default;
+
+        public:
+            Core::JSON::String Keyword;
+            Core::JSON::DecUInt32 Confidence;
+        };
+
+    } // namespace KeywordDetection
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,95 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ImaAdpcmDecoder.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    static constexpr int16_t STEP_SIZES[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+        19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+        130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+        337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+        5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    static constexpr int8_t INDEX_ADJUSTMENTS[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+    static inline int16_t Expand(const uint8_t code, int32_t& predictor, int32_t& index)
+    {
+        const int32_t step = STEP_SIZES[index];
+
+        // step * (code & 7) / 4 + step / 8, computed the way the encoder does it
+        int32_t difference = step >> 3;
+        if ((code & 0x4) != 0) {
+            difference += step;
+        }
+        if ((code & 0x2) != 0) {
+            difference += (step >> 1);
+        }
+        if ((code & 0x1) != 0) {
+            difference += (step >> 2);
+        }
+
+        predictor += ((code & 0x8) != 0) ? -difference : difference;
+        predictor = (predictor > 32767) ? 32767 : ((predictor < -32768) ? -32768 : predictor);
+
+        index += INDEX_ADJUSTMENTS[code & 0x7];
+        index = (index > 88) ? 88 : ((index < 0) ? 0 : index);
+
+        return static_cast<int16_t>(predictor);
+    }
+
+    bool ImaAdpcmDecoder::Configure(const uint32_t sampleRate, const uint8_t channels)
+    {
+        return ((sampleRate > 0) && (channels == 1));
+    }
+
+    void ImaAdpcmDecoder::Reset()
+    {
+        // All state is carried by the block headers
+    }
+
+    size_t ImaAdpcmDecoder::Decode(const uint8_t data[], const uint16_t length, int16_t output[], const size_t capacity)
+    {
+        if ((length < HEADER_SIZE) || (capacity == 0) || (data[2] > 88)) {
+            return 0;
+        }
+
+        int32_t predictor = static_cast<int16_t>(data[0] | (data[1] << 8));
+        int32_t index = data[2];
+        size_t produced = 0;
+
+        output[produced++] = static_cast<int16_t>(predictor);
+
+        for (uint16_t position = HEADER_SIZE; (position < length) && ((produced + 2) <= capacity); ++position) {
+            output[produced++] = Expand(data[position] & 0x0F, predictor, index);
+            output[produced++] = Expand(data[position] >> 4, predictor, index);
+        }
+
+        return produced;
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
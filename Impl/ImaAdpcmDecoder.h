@@ -0,0 +1,58 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "VoiceDecoder.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Mono IMA/DVI ADPCM.
+     *
+     * Each packet is a self-contained block: a four byte header holding the first sample
+     * (16-bit little endian) and the step index, followed by 4-bit codes, low nibble first.
+     * Because the predictor is restarted by every block, a lost packet does not corrupt
+     * the ones after it.
+     */
+    class ImaAdpcmDecoder : public VoiceDecoder {
+    public:
+        ImaAdpcmDecoder(const ImaAdpcmDecoder&) = delete;
+        ImaAdpcmDecoder& operator=(const ImaAdpcmDecoder&) = delete;
+
+        ImaAdpcmDecoder() = default;
+        ~ImaAdpcmDecoder() override = default;
+
+    public:
+        const char* Name() const override
+        {
+            return ("ima-adpcm");
+        }
+
+        bool Configure(const uint32_t sampleRate, const uint8_t channels) override;
+        void Reset() override;
+        size_t Decode(const uint8_t data[], const uint16_t length, int16_t output[], const size_t capacity) override;
+
+    private:
+        static constexpr uint16_t HEADER_SIZE = 4;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,516 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KeywordDetector.h"
+
+#include "Module.h"
+#include "CompatibleAudioFormat.h"
+#include "ReferenceKeywordDetector.h"
+#if defined(KWD_PRYON)
+#include "PryonKeywordDetector.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <time.h>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    using namespace alexaClientSDK::avsCommon;
+    using namespace alexaClientSDK::avsCommon::avs;
+    using namespace alexaClientSDK::avsCommon::sdkInterfaces;
+
+    constexpr const char* KeywordDetector::DEFAULT_ENGINE;
+    constexpr const char* KeywordDetector::DEFAULT_LOCALE;
+    constexpr const char* KeywordDetector::DEFAULT_KEYWORD;
+    constexpr uint32_t KeywordDetector::DEFAULT_THRESHOLD;
+    constexpr uint32_t KeywordDetector::MIN_THRESHOLD;
+    constexpr uint32_t KeywordDetector::MAX_THRESHOLD;
+
+    static const size_t HERTZ_PER_KILOHERTZ = 1000;
+    static const std::chrono::milliseconds TIMEOUT_FOR_READ_CALLS = std::chrono::milliseconds(1000);
+    // Audio read per wake up while there is voice activity
+    static const std::chrono::milliseconds SPEECH_BATCH = std::chrono::milliseconds(10);
+    // Audio collected per wake up while there is no voice activity
+    static const std::chrono::milliseconds IDLE_BATCH = std::chrono::milliseconds(100);
+    static constexpr const char* THREAD_NAME = "AVSKeyword";
+    // First stage of the cascade: audio held back for the engine, the blocks the level is
+    // measured in, and how far above the background, for how long, opens the gate
+    static const std::chrono::milliseconds CASCADE_WINDOW = std::chrono::milliseconds(1000);
+    static const std::chrono::milliseconds GATE_BLOCK = std::chrono::milliseconds(10);
+    static constexpr float GATE_MARGIN = 9.0f;
+    static constexpr uint32_t GATE_ONSET = 2;
+    // Blocks the gate stays open after the level dropped. The engine's voice activity keeps it
+    // open as well, this only bridges the gaps in between words.
+    static constexpr uint32_t GATE_HANGOVER = 150;
+
+    // CPU time consumed by the calling thread, in nanoseconds
+    static uint64_t ThreadTime()
+    {
+        struct timespec now;
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return ((static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + now.tv_nsec);
+    }
+
+    namespace {
+
+        template <typename DETECTOR>
+        std::unique_ptr<KeywordDetector> Make(
+            std::shared_ptr<AudioInputStream> stream,
+            const utils::AudioFormat& audioFormat,
+            const KeywordDetector::KeyWordObservers& keyWordObservers,
+            const KeywordDetector::StateObservers& keyWordDetectorStateObservers,
+            const std::string& modelsPath,
+            const ThreadScheduling& scheduling)
+        {
+            return (DETECTOR::create(stream, audioFormat, keyWordObservers, keyWordDetectorStateObservers, modelsPath, scheduling));
+        }
+
+        struct Entry {
+            const char* name;
+            // SDK configuration the engine expects in the models path, nullptr if none
+            const char* configuration;
+            std::unique_ptr<KeywordDetector> (*create)(
+                std::shared_ptr<AudioInputStream>,
+                const utils::AudioFormat&,
+                const KeywordDetector::KeyWordObservers&,
+                const KeywordDetector::StateObservers&,
+                const std::string&,
+                const ThreadScheduling&);
+        };
+
+        // A new engine is added by implementing KeywordDetector and listing it here
+        const Entry ENGINES[] = {
+#if defined(KWD_PRYON)
+            { "pryon", "localeToModels.json", &Make<PryonKeywordDetector> },
+#endif
+            { "reference", nullptr, &Make<ReferenceKeywordDetector> },
+        };
+
+        const Entry* Find(const std::string& engine)
+        {
+            for (const Entry& entry : ENGINES) {
+                if (engine == entry.name) {
+                    return (&entry);
+                }
+            }
+            return (nullptr);
+        }
+
+    } // namespace
+
+    std::unique_ptr<KeywordDetector> KeywordDetector::Create(
+        const std::string& engine,
+        std::shared_ptr<AudioInputStream> stream,
+        const utils::AudioFormat& audioFormat,
+        const KeyWordObservers& keyWordObservers,
+        const StateObservers& keyWordDetectorStateObservers,
+        const std::string& modelsPath,
+        const ThreadScheduling& scheduling)
+    {
+        const Entry* entry = Find(engine);
+        if (entry == nullptr) {
+            TRACE_GLOBAL(AVSClient, (_T("Keyword detection engine '%s' is not available"), engine.c_str()));
+            return nullptr;
+        }
+        return (entry->create(stream, audioFormat, keyWordObservers, keyWordDetectorStateObservers, modelsPath, scheduling));
+    }
+
+    bool KeywordDetector::IsAvailable(const std::string& engine)
+    {
+        return (Find(engine) != nullptr);
+    }
+
+    std::string KeywordDetector::Configuration(const std::string& engine)
+    {
+        const Entry* entry = Find(engine);
+        return (((entry != nullptr) && (entry->configuration != nullptr)) ? entry->configuration : "");
+    }
+
+    KeywordDetector::KeywordDetector(
+        std::shared_ptr<AudioInputStream> stream,
+        const KeyWordObservers& keyWordObservers,
+        const StateObservers& keyWordDetectorStateObservers,
+        const ThreadScheduling& scheduling)
+        : AbstractKeywordDetector(keyWordObservers, keyWordDetectorStateObservers)
+        , m_isShuttingDown{ false }
+        , m_stream{ stream }
+        , m_streamReader{ nullptr }
+        , m_detectionThread{}
+        , m_scheduling(scheduling)
+        , m_frameSize{ 1 }
+        , m_lock()
+        , m_voiceActivity()
+        , m_detection()
+        , m_thresholds()
+        , m_isThresholdChanged{ false }
+        , m_isSpeech{ false }
+        , m_isCascaded{ false }
+        , m_gate(GATE_MARGIN, GATE_ONSET, GATE_HANGOVER)
+        , m_isOpen{ true }
+        , m_window()
+        , m_windowSize{ 0 }
+        , m_windowIndex{ 0 }
+        , m_pushedSamples{ 0 }
+        , m_detections{ 0 }
+        , m_overruns{ 0 }
+        , m_skippedSamples{ 0 }
+        , m_processingTime{ 0 }
+        , m_speechSamples{ 0 }
+        , m_idleTime{ 0 }
+        , m_lateReads{ 0 }
+        , m_maxBacklog{ 0 }
+        , m_gatedSamples{ 0 }
+        , m_gateOpenings{ 0 }
+    {
+    }
+
+    KeywordDetector::~KeywordDetector()
+    {
+        // The engine should have stopped the thread already, it is too late for Push() by now
+        ASSERT(m_detectionThread.joinable() == false);
+        Stop();
+    }
+
+    bool KeywordDetector::Start(const size_t frameSize)
+    {
+        m_streamReader = m_stream->createReader(AudioInputStream::Reader::Policy::BLOCKING);
+        if (!m_streamReader) {
+            TRACE(AVSClient, (_T("Failed to start %s keyword detection: m_streamReader is nullptr"), Name()));
+            return false;
+        }
+
+        m_frameSize = std::max(frameSize, static_cast<size_t>(1));
+        // Whole frames only, the engine gets the window in one push
+        const size_t window = (AudioFormatCompatibility::SAMPLE_RATE_HZ / HERTZ_PER_KILOHERTZ) * CASCADE_WINDOW.count();
+        m_windowSize = ((window + m_frameSize - 1) / m_frameSize) * m_frameSize;
+        m_window.reserve(m_windowSize + (AudioFormatCompatibility::SAMPLE_RATE_HZ / HERTZ_PER_KILOHERTZ) * IDLE_BATCH.count() + m_frameSize);
+        m_isShuttingDown = false;
+        m_detectionThread = std::thread(&KeywordDetector::DetectionLoop, this);
+        return true;
+    }
+
+    void KeywordDetector::Stop()
+    {
+        m_isShuttingDown = true;
+        if (m_detectionThread.joinable()) {
+            m_detectionThread.join();
+        }
+    }
+
+    bool KeywordDetector::SetThreshold(const std::string& keyword, const uint32_t threshold)
+    {
+        if ((threshold < MIN_THRESHOLD) || (threshold > MAX_THRESHOLD)) {
+            TRACE(AVSClient, (_T("Detection threshold %u out of range"), threshold));
+            return false;
+        }
+        if (keyword.empty() == true) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_thresholds[ToUpper(keyword)] = threshold;
+        }
+        m_isThresholdChanged = true;
+        return true;
+    }
+
+    uint32_t KeywordDetector::Threshold(const std::string& keyword) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto entry = m_thresholds.find(ToUpper(keyword));
+        return ((entry != m_thresholds.end()) ? entry->second : DEFAULT_THRESHOLD);
+    }
+
+    bool KeywordDetector::SetThresholds(const std::string& thresholds)
+    {
+        // Validate the whole list before anything is applied
+        std::map<std::string, uint32_t> entries;
+        std::istringstream list(thresholds);
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+            if (item.empty() == true) {
+                continue;
+            }
+
+            const size_t separator = item.find('=');
+            if ((separator == 0) || (separator == std::string::npos) || (separator == (item.size() - 1))
+                || (item.find_first_not_of("0123456789", separator + 1) != std::string::npos)
+                || ((item.size() - separator - 1) > 4)) {
+                TRACE(AVSClient, (_T("Malformed detection threshold '%s'"), item.c_str()));
+                return false;
+            }
+
+            const uint32_t threshold = static_cast<uint32_t>(std::stoul(item.substr(separator + 1)));
+            if ((threshold < MIN_THRESHOLD) || (threshold > MAX_THRESHOLD)) {
+                TRACE(AVSClient, (_T("Detection threshold of %s out of range"), item.c_str()));
+                return false;
+            }
+            entries[ToUpper(item.substr(0, separator))] = threshold;
+        }
+
+        for (const auto& entry : entries) {
+            SetThreshold(entry.first, entry.second);
+        }
+        return true;
+    }
+
+    void KeywordDetector::Memory(Diagnostics::MemoryStatistics&) const
+    {
+        // Nothing beyond the stream itself by default
+    }
+
+    void KeywordDetector::Statistics(Diagnostics::KeywordStatistics& statistics) const
+    {
+        const uint64_t pushedSamples = m_pushedSamples.load(std::memory_order_relaxed);
+        const uint64_t speechSamples = m_speechSamples.load(std::memory_order_relaxed);
+        const uint64_t idleSamples = pushedSamples - std::min(speechSamples, pushedSamples);
+        const uint64_t samplesPerMillisecond = AudioFormatCompatibility::SAMPLE_RATE_HZ / HERTZ_PER_KILOHERTZ;
+
+        statistics.Detections = m_detections.load(std::memory_order_relaxed);
+        statistics.Audio = pushedSamples / samplesPerMillisecond;
+        statistics.Overruns = m_overruns.load(std::memory_order_relaxed);
+        statistics.Skipped = m_skippedSamples.load(std::memory_order_relaxed) / samplesPerMillisecond;
+        statistics.Speech = speechSamples / samplesPerMillisecond;
+        statistics.Late = m_lateReads.load(std::memory_order_relaxed);
+        statistics.MaxBacklog = m_maxBacklog.load(std::memory_order_relaxed) / samplesPerMillisecond;
+        statistics.Gated = m_gatedSamples.load(std::memory_order_relaxed) / samplesPerMillisecond;
+        statistics.GateOpenings = m_gateOpenings.load(std::memory_order_relaxed);
+
+        // Microseconds of CPU spent per second of audio pushed to the engine
+        statistics.ProcessingCost = (pushedSamples > 0) ? static_cast<uint32_t>(((m_processingTime.load(std::memory_order_relaxed) / 1000) * AudioFormatCompatibility::SAMPLE_RATE_HZ) / pushedSamples) : 0;
+        // The same, for the audio without voice activity only
+        statistics.IdleCost = (idleSamples > 0) ? static_cast<uint32_t>(((m_idleTime.load(std::memory_order_relaxed) / 1000) * AudioFormatCompatibility::SAMPLE_RATE_HZ) / idleSamples) : 0;
+    }
+
+    void KeywordDetector::DetectionLoop()
+    {
+        // The engine consumes whole frames only. A read that ends inside a frame leaves a remainder
+        // at the front of the buffer, which is completed by the next read.
+        const size_t frameSize = m_frameSize;
+        const size_t samplesPerMillisecond = AudioFormatCompatibility::SAMPLE_RATE_HZ / HERTZ_PER_KILOHERTZ;
+        const size_t readSize = std::max(static_cast<size_t>(samplesPerMillisecond * SPEECH_BATCH.count()), frameSize);
+        // Without voice activity the loop wakes up once per IDLE_BATCH instead of once per read
+        const size_t idleReadSize = std::max(readSize, static_cast<size_t>(samplesPerMillisecond * IDLE_BATCH.count()));
+        std::vector<int16_t> audioDataToPush(idleReadSize + frameSize);
+        // Stream index of the first sample in audioDataToPush
+        AudioInputStream::Index bufferIndex = m_streamReader->tell();
+        // More audio than one pass of the loop consumes means the thread did not get the CPU in time
+        const uint64_t lateBacklog = idleReadSize + readSize;
+        size_t pending = 0;
+        bool isRunning = true;
+
+        m_scheduling.Apply(THREAD_NAME);
+
+        notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::ACTIVE);
+
+        while ((!m_isShuttingDown) && (isRunning == true)) {
+            const bool isSpeech = m_isSpeech;
+            const uint64_t start = ThreadTime();
+            const ssize_t wordsRead = m_streamReader->read(&audioDataToPush[pending], (isSpeech == true) ? readSize : idleReadSize, TIMEOUT_FOR_READ_CALLS);
+
+            if (wordsRead > 0) {
+                const uint64_t backlog = m_streamReader->tell(AudioInputStream::Reader::Reference::BEFORE_WRITER);
+                if (backlog > lateBacklog) {
+                    m_lateReads.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (backlog > m_maxBacklog.load(std::memory_order_relaxed)) {
+                    m_maxBacklog.store(backlog, std::memory_order_relaxed);
+                }
+
+                pending += wordsRead;
+                const size_t frames = pending - (pending % frameSize);
+                if (frames > 0) {
+                    if (Feed(audioDataToPush.data(), frames, bufferIndex) == false) {
+                        notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::ERROR);
+                        isRunning = false;
+                    }
+                    pending -= frames;
+                    bufferIndex += frames;
+                    ::memmove(audioDataToPush.data(), &audioDataToPush[frames], pending * sizeof(int16_t));
+                    m_pushedSamples.fetch_add(frames, std::memory_order_relaxed);
+                    if (isSpeech == true) {
+                        m_speechSamples.fetch_add(frames, std::memory_order_relaxed);
+                    }
+                }
+
+                const uint64_t cost = ThreadTime() - start;
+                m_processingTime.fetch_add(cost, std::memory_order_relaxed);
+                if (isSpeech == false) {
+                    m_idleTime.fetch_add(cost, std::memory_order_relaxed);
+                }
+
+                // Silence and caught up with the writer: let the next batch build up. A wake word that
+                // starts meanwhile is still detected, at most one batch later.
+                if ((m_isSpeech == false) && (static_cast<size_t>(wordsRead) < idleReadSize) && (!m_isShuttingDown)) {
+                    std::this_thread::sleep_for((IDLE_BATCH * (idleReadSize - wordsRead)) / idleReadSize);
+                }
+            } else if (wordsRead == AudioInputStream::Reader::Error::OVERRUN) {
+                // The writer lapped this reader. Resume at the writer, the audio in between is gone anyway.
+                const AudioInputStream::Index before = m_streamReader->tell();
+                if (m_streamReader->seek(0, AudioInputStream::Reader::Reference::BEFORE_WRITER) == true) {
+                    m_overruns.fetch_add(1, std::memory_order_relaxed);
+                    m_skippedSamples.fetch_add(m_streamReader->tell() - before, std::memory_order_relaxed);
+                    pending = 0;
+                    bufferIndex = m_streamReader->tell();
+                    TRACE(AVSClient, (_T("Overrun in detection loop, skipped %llu samples"), static_cast<unsigned long long>(m_streamReader->tell() - before)));
+                } else {
+                    TRACE(AVSClient, (_T("Failed to recover from an overrun in detection loop")));
+                    notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::ERROR);
+                    isRunning = false;
+                }
+            } else if (wordsRead == AudioInputStream::Reader::Error::TIMEDOUT) {
+                // Nothing written for a while, the blocking read is the back-off
+            } else if (wordsRead == AudioInputStream::Reader::Error::CLOSED) {
+                notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::STREAM_CLOSED);
+                isRunning = false;
+            } else {
+                TRACE(AVSClient, (_T("Unhandled error (%zd) in detection loop"), wordsRead));
+                notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::ERROR);
+                isRunning = false;
+            }
+        }
+
+        m_streamReader->close();
+        TRACE_L1(_T("End of detection thread"));
+    }
+
+    bool KeywordDetector::Feed(const int16_t samples[], const size_t count, const Index streamIndex)
+    {
+        bool isActive = true;
+
+        if (m_isCascaded == true) {
+            const size_t block = (AudioFormatCompatibility::SAMPLE_RATE_HZ / HERTZ_PER_KILOHERTZ) * GATE_BLOCK.count();
+            for (size_t offset = 0; (offset + block) <= count; offset += block) {
+                m_gate.Process(&samples[offset], block);
+            }
+            // Once open, the gate stays open for as long as the engine hears voice
+            isActive = (m_gate.IsActive() == true) || (m_isSpeech == true);
+        }
+
+        if (isActive == false) {
+            if (m_isOpen == true) {
+                TRACE_L1(_T("Keyword detection gate closed"));
+                m_isOpen = false;
+            }
+            Hold(samples, count, streamIndex);
+            return true;
+        }
+
+        bool result = true;
+        if (m_isOpen == false) {
+            TRACE_L1(_T("Keyword detection gate opened"));
+            m_isOpen = true;
+            m_gateOpenings.fetch_add(1, std::memory_order_relaxed);
+
+            // The engine hears the audio leading up to the trigger first, at its own stream indices,
+            // so the wake word boundaries it reports are as exact as without the cascade
+            if ((m_window.empty() == false) && ((m_windowIndex + m_window.size()) == streamIndex)) {
+                result = Push(m_window.data(), m_window.size(), m_windowIndex);
+            } else {
+                m_gatedSamples.fetch_add(m_window.size(), std::memory_order_relaxed);
+            }
+            m_window.clear();
+        }
+
+        return ((Push(samples, count, streamIndex) == true) && (result == true));
+    }
+
+    void KeywordDetector::Hold(const int16_t samples[], const size_t count, const Index streamIndex)
+    {
+        // Audio skipped after an overrun breaks the window, what is before the gap is of no use
+        if ((m_window.empty() == false) && ((m_windowIndex + m_window.size()) != streamIndex)) {
+            m_gatedSamples.fetch_add(m_window.size(), std::memory_order_relaxed);
+            m_window.clear();
+        }
+        if (m_window.empty() == true) {
+            m_windowIndex = streamIndex;
+        }
+
+        m_window.insert(m_window.end(), samples, samples + count);
+        if (m_window.size() > m_windowSize) {
+            const size_t excess = m_window.size() - m_windowSize;
+            const size_t dropped = ((excess + m_frameSize - 1) / m_frameSize) * m_frameSize;
+            m_window.erase(m_window.begin(), m_window.begin() + dropped);
+            m_windowIndex += dropped;
+            m_gatedSamples.fetch_add(dropped, std::memory_order_relaxed);
+        }
+    }
+
+    void KeywordDetector::VoiceActivity(const VoiceActivityHandler& handler)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_voiceActivity = handler;
+    }
+
+    void KeywordDetector::Detection(const DetectionHandler& handler)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_detection = handler;
+    }
+
+    void KeywordDetector::Detected(const std::string& keyword, const Index begin, const Index end, const uint32_t confidence)
+    {
+        m_detections.fetch_add(1, std::memory_order_relaxed);
+
+        TRACE(AVSClient, (_T("Detected %s with confidence %u (threshold %u)"), keyword.c_str(), confidence, Threshold(keyword)));
+
+        DetectionHandler handler;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            handler = m_detection;
+        }
+        if (handler) {
+            handler(keyword, confidence);
+        }
+
+        notifyKeyWordObservers(m_stream, keyword, begin, end);
+    }
+
+    void KeywordDetector::VoiceActivityChanged(const bool isSpeech)
+    {
+        if (m_isSpeech.exchange(isSpeech) != isSpeech) {
+            TRACE_L1(_T("Voice activity %s"), (isSpeech == true) ? _T("started") : _T("stopped"));
+
+            VoiceActivityHandler handler;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                handler = m_voiceActivity;
+            }
+            if (handler) {
+                handler(isSpeech);
+            }
+        }
+    }
+
+    /* static */ std::string KeywordDetector::ToUpper(const std::string& text)
+    {
+        std::string result(text);
+        std::transform(result.begin(), result.end(), result.begin(), ::toupper);
+        return (result);
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,222 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <AVSCommon/AVS/AudioInputStream.h>
+#include <AVSCommon/SDKInterfaces/KeyWordDetectorStateObserverInterface.h>
+#include <AVSCommon/SDKInterfaces/KeyWordObserverInterface.h>
+#include <AVSCommon/Utils/AudioFormat.h>
+#include <KWD/AbstractKeywordDetector.h>
+
+#include "EnergyDetector.h"
+#include "IAVSDiagnostics.h"
+#include "ThreadScheduling.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Wake word detector reading the shared audio stream on a thread of its own.
+     *
+     * The base class runs the detection loop: it reads the stream, recovers from overruns, reads
+     * in larger batches while there is no voice activity and accounts for all of it. An engine
+     * gets whole frames of audio through Push() and reports wake words and voice activity back.
+     * Cascaded, a level based first stage holds the audio back from the engine until something
+     * louder than the background comes along.
+     * Engines are listed in KeywordDetector.cpp and created by name.
+     */
+    class KeywordDetector : public alexaClientSDK::kwd::AbstractKeywordDetector {
+    public:
+        using Index = alexaClientSDK::avsCommon::avs::AudioInputStream::Index;
+        using KeyWordObservers = std::unordered_set<std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordObserverInterface>>;
+        using StateObservers = std::unordered_set<std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordDetectorStateObserverInterface>>;
+        using VoiceActivityHandler = std::function<void(const bool active)>;
+        using DetectionHandler = std::function<void(const std::string& keyword, const uint32_t confidence)>;
+
+#if defined(KWD_PRYON)
+        static constexpr const char* DEFAULT_ENGINE = "pryon";
+#else
+        static constexpr const char* DEFAULT_ENGINE = "reference";
+#endif
+        static constexpr const char* DEFAULT_LOCALE = "en-US";
+        static constexpr const char* DEFAULT_KEYWORD = "ALEXA";
+        static constexpr uint32_t DEFAULT_THRESHOLD = 200;
+        static constexpr uint32_t MIN_THRESHOLD = 1;
+        static constexpr uint32_t MAX_THRESHOLD = 1000;
+
+        KeywordDetector(const KeywordDetector&) = delete;
+        KeywordDetector& operator=(const KeywordDetector&) = delete;
+
+        ~KeywordDetector() override;
+
+        /// Creates the engine registered under name and starts it, nullptr if there is none or it fails to start.
+        static std::unique_ptr<KeywordDetector> Create(
+            const std::string& engine,
+            std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream,
+            const alexaClientSDK::avsCommon::utils::AudioFormat& audioFormat,
+            const KeyWordObservers& keyWordObservers,
+            const StateObservers& keyWordDetectorStateObservers,
+            const std::string& modelsPath,
+            const ThreadScheduling& scheduling = ThreadScheduling());
+        static bool IsAvailable(const std::string& engine);
+        /// File in the models path to be added to the SDK configuration for the engine, empty if it needs none
+        static std::string Configuration(const std::string& engine);
+
+    public:
+        virtual const char* Name() const = 0;
+
+        // A new locale or keyword is loaded next to the current one, which keeps detecting until
+        // the engine has switched over
+        virtual bool SetLocale(const std::string& locale) = 0;
+        virtual bool SetKeyword(const std::string& keyword) = 0;
+        virtual std::string Locale() const = 0;
+        virtual std::string Keyword() const = 0;
+
+        virtual void Memory(Diagnostics::MemoryStatistics& statistics) const;
+        void Statistics(Diagnostics::KeywordStatistics& statistics) const;
+
+        // Detection threshold per keyword, MIN_THRESHOLD (most sensitive) to MAX_THRESHOLD, applied
+        // between two pushes. Keywords without a threshold of their own use DEFAULT_THRESHOLD.
+        bool SetThreshold(const std::string& keyword, const uint32_t threshold);
+        uint32_t Threshold(const std::string& keyword) const;
+        // The same, for the keyword currently detected
+        bool SetThreshold(const uint32_t threshold)
+        {
+            return (SetThreshold(Keyword(), threshold));
+        }
+        uint32_t Threshold() const
+        {
+            return (Threshold(Keyword()));
+        }
+        // Thresholds as listed in the plugin configuration, e.g. "ALEXA=200,COMPUTER=450"
+        bool SetThresholds(const std::string& thresholds);
+
+        // Stream index up to which audio has been read. Asked from a keyword observer, it is the
+        // point in the stream at which the wake word was recognised.
+        Index Position() const
+        {
+            return (m_streamReader->tell());
+        }
+
+        // Called on the detection thread whenever the engine's voice activity detection changes its mind
+        void VoiceActivity(const VoiceActivityHandler& handler);
+        // Called on the detection thread for every reported wake word, with the engine's confidence
+        void Detection(const DetectionHandler& handler);
+        bool IsSpeech() const
+        {
+            return (m_isSpeech);
+        }
+
+        // Two stage detection: the engine only hears the audio from CASCADE_WINDOW before the
+        // level rises above the background until its own voice activity detection has ended
+        void Cascade(const bool enabled)
+        {
+            m_isCascaded = enabled;
+        }
+        bool IsCascaded() const
+        {
+            return (m_isCascaded);
+        }
+
+    protected:
+        KeywordDetector(
+            std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream,
+            const KeyWordObservers& keyWordObservers,
+            const StateObservers& keyWordDetectorStateObservers,
+            const ThreadScheduling& scheduling);
+
+        // Starts the detection thread, which pushes audio in multiples of frameSize samples
+        bool Start(const size_t frameSize);
+        // Joins the detection thread. An engine calls it from its destructor, before anything
+        // Push() relies on goes away.
+        void Stop();
+
+        // Runs on the detection thread with whole frames of audio, the first of which is at streamIndex
+        virtual bool Push(const int16_t samples[], const size_t count, const Index streamIndex) = 0;
+
+        // For Push(): true once after a threshold has been changed
+        bool IsThresholdChanged()
+        {
+            return (m_isThresholdChanged.exchange(false));
+        }
+        // For Push(): reports a wake word between the stream indices begin and end
+        void Detected(const std::string& keyword, const Index begin, const Index end, const uint32_t confidence);
+        // For Push(): reports the voice activity of the audio pushed last
+        void VoiceActivityChanged(const bool isSpeech);
+
+        static std::string ToUpper(const std::string& text);
+
+    private:
+        void DetectionLoop();
+        // Runs the first stage, if cascaded, and pushes what gets past it to the engine
+        bool Feed(const int16_t samples[], const size_t count, const Index streamIndex);
+        void Hold(const int16_t samples[], const size_t count, const Index streamIndex);
+
+        std::atomic<bool> m_isShuttingDown;
+        const std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> m_stream;
+        std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream::Reader> m_streamReader;
+        std::thread m_detectionThread;
+        const ThreadScheduling m_scheduling;
+        size_t m_frameSize;
+
+        // Guards the handlers and thresholds
+        mutable std::mutex m_lock;
+        VoiceActivityHandler m_voiceActivity;
+        DetectionHandler m_detection;
+        std::map<std::string, uint32_t> m_thresholds;
+        std::atomic<bool> m_isThresholdChanged;
+        std::atomic<bool> m_isSpeech;
+        std::atomic<bool> m_isCascaded;
+
+        // First stage, owned by the detection thread. The window holds the latest audio the
+        // engine has not heard, the first sample of it at m_windowIndex.
+        EnergyDetector m_gate;
+        bool m_isOpen;
+        std::vector<int16_t> m_window;
+        size_t m_windowSize;
+        Index m_windowIndex;
+
+        // Updated by the detection thread, read by diagnostics
+        std::atomic<uint64_t> m_pushedSamples;
+        std::atomic<uint64_t> m_detections;
+        std::atomic<uint64_t> m_overruns;
+        std::atomic<uint64_t> m_skippedSamples;
+        std::atomic<uint64_t> m_processingTime;
+        std::atomic<uint64_t> m_speechSamples;
+        std::atomic<uint64_t> m_idleTime;
+        std::atomic<uint64_t> m_lateReads;
+        std::atomic<uint64_t> m_maxBacklog;
+        std::atomic<uint64_t> m_gatedSamples;
+        std::atomic<uint64_t> m_gateOpenings;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,179 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KeywordModel.h"
+#include "TraceCategories.h"
+
+#include <algorithm>
+#include <map>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    static std::mutex g_modelsLock;
+    static std::map<std::string, std::weak_ptr<const KeywordModel>> g_models;
+
+    /* static */ std::shared_ptr<const KeywordModel> KeywordModel::Open(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(g_modelsLock);
+
+        std::shared_ptr<const KeywordModel> model = g_models[path].lock();
+        if (model) {
+            return model;
+        }
+
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            TRACE_GLOBAL(AVSClient, (_T("Failed to open model file %s"), path.c_str()));
+            return nullptr;
+        }
+
+        struct stat properties;
+        void* data = MAP_FAILED;
+        if ((::fstat(fd, &properties) == 0) && (properties.st_size > 0)) {
+            data = ::mmap(nullptr, properties.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+
+        if (data == MAP_FAILED) {
+            TRACE_GLOBAL(AVSClient, (_T("Failed to map model file %s"), path.c_str()));
+            return nullptr;
+        }
+
+        // The decoder walks the whole model on every frame
+        ::madvise(data, properties.st_size, MADV_WILLNEED);
+
+        model.reset(new KeywordModel(path, static_cast<const uint8_t*>(data), properties.st_size));
+        g_models[path] = model;
+
+        return model;
+    }
+
+    KeywordModel::KeywordModel(const std::string& path, const uint8_t* data, const size_t size)
+        : m_path{ path }
+        , m_data{ data }
+        , m_size{ size }
+    {
+    }
+
+    KeywordModel::~KeywordModel()
+    {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+
+    size_t KeywordModel::Resident() const
+    {
+        const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+        const size_t pages = (m_size + pageSize - 1) / pageSize;
+        std::unique_ptr<unsigned char[]> residency(new unsigned char[pages]);
+
+        size_t resident = 0;
+        if (::mincore(const_cast<uint8_t*>(m_data), m_size, residency.get()) == 0) {
+            for (size_t page = 0; page < pages; ++page) {
+                if ((residency[page] & 1) != 0) {
+                    resident += pageSize;
+                }
+            }
+        }
+
+        return std::min(resident, m_size);
+    }
+
+    void DecoderArena::Releaser::operator()(char* block) const
+    {
+        DecoderArena::Instance().Release(block, size);
+    }
+
+    /* static */ DecoderArena& DecoderArena::Instance()
+    {
+        static DecoderArena arena;
+        return arena;
+    }
+
+    DecoderArena::DecoderArena()
+        : m_lock()
+        , m_free{ nullptr }
+        , m_freeSize{ 0 }
+        , m_usedSize{ 0 }
+    {
+    }
+
+    DecoderArena::~DecoderArena()
+    {
+        ::free(m_free);
+    }
+
+    DecoderArena::Block DecoderArena::Acquire(const size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        char* block = nullptr;
+        size_t blockSize = size;
+
+        if ((m_free != nullptr) && (m_freeSize >= size)) {
+            block = m_free;
+            blockSize = m_freeSize;
+            m_free = nullptr;
+            m_freeSize = 0;
+        } else {
+            void* memory = nullptr;
+            const size_t rounded = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            if (::posix_memalign(&memory, ALIGNMENT, rounded) == 0) {
+                block = static_cast<char*>(memory);
+                blockSize = rounded;
+            }
+        }
+
+        if (block != nullptr) {
+            ::memset(block, 0, blockSize);
+            m_usedSize += blockSize;
+        }
+
+        return Block(block, Releaser{ blockSize });
+    }
+
+    void DecoderArena::Release(char* block, const size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_usedSize -= size;
+
+        // Keep the larger of the two blocks for the next decoder
+        if (size > m_freeSize) {
+            std::swap(block, m_free);
+            m_freeSize = size;
+        }
+        ::free(block);
+    }
+
+    size_t DecoderArena::Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return (m_usedSize + m_freeSize);
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
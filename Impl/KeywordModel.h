@@ -0,0 +1,114 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Read-only mapping of a keyword detection model file.
+     *
+     * Models are shared: opening a path that is already mapped returns the existing mapping, and
+     * the pages come from the page cache, so other processes mapping the same file share them too.
+     */
+    class KeywordModel {
+    public:
+        KeywordModel(const KeywordModel&) = delete;
+        KeywordModel& operator=(const KeywordModel&) = delete;
+
+        ~KeywordModel();
+
+        static std::shared_ptr<const KeywordModel> Open(const std::string& path);
+
+    public:
+        const uint8_t* Data() const
+        {
+            return (m_data);
+        }
+        size_t Size() const
+        {
+            return (m_size);
+        }
+        const std::string& Path() const
+        {
+            return (m_path);
+        }
+
+        /// Number of bytes of the model currently resident in RAM
+        size_t Resident() const;
+
+    private:
+        KeywordModel(const std::string& path, const uint8_t* data, const size_t size);
+
+    private:
+        const std::string m_path;
+        const uint8_t* m_data;
+        const size_t m_size;
+    };
+
+    /**
+     * Cache line aligned memory for the keyword decoder.
+     *
+     * A released block is kept and handed out again to the next decoder that fits in it, so a
+     * detector restart or locale change does not go back to the allocator.
+     */
+    class DecoderArena {
+    public:
+        static constexpr size_t ALIGNMENT = 64;
+
+        struct Releaser {
+            size_t size;
+            void operator()(char* block) const;
+        };
+        using Block = std::unique_ptr<char, Releaser>;
+
+        DecoderArena(const DecoderArena&) = delete;
+        DecoderArena& operator=(const DecoderArena&) = delete;
+
+        static DecoderArena& Instance();
+
+    public:
+        /// Returns a zeroed block of at least size bytes, empty when out of memory.
+        Block Acquire(const size_t size);
+
+        /// Bytes held by the arena, in use or kept for reuse
+        size_t Size() const;
+
+    private:
+        DecoderArena();
+        ~DecoderArena();
+
+        void Release(char* block, const size_t size);
+
+    private:
+        mutable std::mutex m_lock;
+        char* m_free;
+        size_t m_freeSize;
+        size_t m_usedSize;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,158 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LogFilter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    namespace {
+
+        struct Alias {
+            const char* component;
+            std::vector<const char*> tags;
+        };
+
+        // Source tags of the SDK libraries that are filtered as a whole
+        const Alias ALIASES[] = {
+            { "ACL", { "AVSConnectionManager", "MessageRouter", "HTTP2Transport", "MessageRequestHandler", "DownchannelHandler",
+                         "ExchangeHandler", "PingHandler", "PostConnectSequencer", "PostConnectSynchronizer",
+                         "LibCurlHTTP2Connection", "LibCurlHTTP2Request", "MessageConsumer" } },
+            { "AIP", { "AudioInputProcessor" } },
+            { "MEDIAPLAYER", { "MediaPlayer" } },
+            { "KWD", { "AbstractKeywordDetector" } }
+        };
+
+        std::string ToUpper(const std::string& input)
+        {
+            std::string output(input);
+            std::transform(output.begin(), output.end(), output.begin(), [](unsigned char c) { return std::toupper(c); });
+            return output;
+        }
+
+    } // namespace
+
+    LogFilter::LogFilter(const Level level)
+        : m_default(level)
+        , m_components()
+        , m_sources()
+    {
+    }
+
+    LogFilter::Level LogFilter::Threshold(const char text[]) const
+    {
+        Level level = m_default;
+
+        if ((m_sources.empty() == false) && (text != nullptr)) {
+            const size_t length = ::strcspn(text, ":");
+            size_t low = 0;
+            size_t high = m_sources.size();
+            while (low < high) {
+                const size_t middle = (low + high) / 2;
+                const int order = Compare(m_sources[middle].tag, text, length);
+                if (order == 0) {
+                    level = m_sources[middle].level;
+                    break;
+                } else if (order < 0) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+        }
+
+        return (level);
+    }
+
+    LogFilter::Level LogFilter::Lowest() const
+    {
+        Level lowest = m_default;
+        for (const auto& component : m_components) {
+            lowest = std::min(lowest, component.second);
+        }
+        return (lowest);
+    }
+
+    void LogFilter::Default(const Level level)
+    {
+        m_default = level;
+    }
+
+    LogFilter::Level LogFilter::Component(const std::string& name) const
+    {
+        const auto entry = m_components.find(ToUpper(name));
+        return ((entry != m_components.end()) ? entry->second : m_default);
+    }
+
+    void LogFilter::Component(const std::string& name, const Level level)
+    {
+        if (level == Level::UNKNOWN) {
+            m_components.erase(ToUpper(name));
+        } else {
+            m_components[ToUpper(name)] = level;
+        }
+        Rebuild();
+    }
+
+    int LogFilter::Compare(const std::string& tag, const char text[], const size_t length)
+    {
+        // The tags are kept upper case, in the order of std::string
+        const size_t common = std::min(tag.size(), length);
+        for (size_t index = 0; index < common; index++) {
+            const unsigned char left = static_cast<unsigned char>(tag[index]);
+            const unsigned char right = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(text[index])));
+            if (left != right) {
+                return ((left < right) ? -1 : 1);
+            }
+        }
+        return ((tag.size() < length) ? -1 : ((tag.size() > length) ? 1 : 0));
+    }
+
+    void LogFilter::Rebuild()
+    {
+        // A source tag given as a component wins over the alias it belongs to
+        std::map<std::string, Level> tags;
+        for (const auto& component : m_components) {
+            for (const Alias& alias : ALIASES) {
+                if (component.first == alias.component) {
+                    for (const char* tag : alias.tags) {
+                        tags.insert(std::make_pair(ToUpper(tag), component.second));
+                    }
+                }
+            }
+        }
+        for (const auto& component : m_components) {
+            if (std::none_of(std::begin(ALIASES), std::end(ALIASES), [&component](const Alias& alias) { return (component.first == alias.component); })) {
+                tags[component.first] = component.second;
+            }
+        }
+
+        m_sources.clear();
+        m_sources.reserve(tags.size());
+        for (const auto& tag : tags) {
+            m_sources.push_back({ tag.first, tag.second });
+        }
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,85 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <AVS/AVSCommon/Utils/Logger/Logger.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Log levels per AVS SDK component, on top of a default level.
+     *
+     * The SDK starts every log line with the tag of the source that logged it ("source:event:..."),
+     * so a line is matched on that tag. A component is either an alias for the tags of an SDK
+     * library (ACL, AIP, MediaPlayer, KWD) or a source tag itself. Names are not case sensitive.
+     *
+     * Threshold() only compares characters, it does not allocate and may run on any thread.
+     * A filter is not changed once shared: changes are made to a copy that replaces it.
+     */
+    class LogFilter {
+    public:
+        typedef alexaClientSDK::avsCommon::utils::logger::Level Level;
+
+        LogFilter(const LogFilter&) = default;
+        LogFilter& operator=(const LogFilter&) = default;
+
+        explicit LogFilter(const Level level);
+        ~LogFilter() = default;
+
+    public:
+        // Level the line is traced from, found by the source tag at the start of the text
+        Level Threshold(const char text[]) const;
+        // Most verbose of the default and the component levels
+        Level Lowest() const;
+
+        Level Default() const
+        {
+            return (m_default);
+        }
+        void Default(const Level level);
+
+        // Level of a component, the default one when it has none of its own
+        Level Component(const std::string& name) const;
+        // A component with the level UNKNOWN falls back to the default level
+        void Component(const std::string& name, const Level level);
+
+    private:
+        struct Source {
+            std::string tag;
+            Level level;
+        };
+
+        static int Compare(const std::string& tag, const char text[], const size_t length);
+        void Rebuild();
+
+    private:
+        Level m_default;
+        std::map<std::string, Level> m_components;
+        // Tags of all components, sorted for the lookup
+        std::vector<Source> m_sources;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
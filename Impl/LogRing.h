@@ -0,0 +1,213 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Bounded multi-producer/single-consumer ring of fixed-size log records.
+     *
+     * Producers are the AVS SDK threads that log, the consumer is the thread that formats the
+     * records and hands them to Thunder tracing. Every slot carries a sequence number, so
+     * producers claim slots with a single compare-and-swap and never wait for each other or
+     * for the consumer. Push() does not allocate: text that does not fit a record is cut off,
+     * a record that does not fit the ring is dropped, and both are counted.
+     */
+    class LogRing {
+    public:
+        static constexpr size_t MONIKER_SIZE = 16;
+        static constexpr size_t TEXT_SIZE = 480;
+
+        struct Record {
+            uint64_t time; // microseconds since the epoch
+            uint8_t severity; // ordered like the levels, the higher the more severe
+            char level;
+            bool isTruncated;
+            bool isTraced; // to be handed to Thunder tracing, not only recorded
+            uint16_t length;
+            char moniker[MONIKER_SIZE];
+            char text[TEXT_SIZE];
+        };
+
+        struct Statistics {
+            size_t capacity;
+            size_t highWaterMark;
+            uint64_t pushedRecords;
+            uint64_t droppedRecords;
+            uint64_t truncatedRecords;
+        };
+
+        LogRing(const LogRing&) = delete;
+        LogRing& operator=(const LogRing&) = delete;
+
+        // The capacity is rounded up to a power of two
+        explicit LogRing(const size_t capacity)
+            : m_mask{ Slots(capacity) - 1 }
+            , m_cells{ new Cell[m_mask + 1] }
+            , m_head{ 0 }
+            , m_tail{ 0 }
+            , m_highWaterMark{ 0 }
+            , m_pushedRecords{ 0 }
+            , m_droppedRecords{ 0 }
+            , m_truncatedRecords{ 0 }
+        {
+            for (size_t index = 0; index <= m_mask; index++) {
+                m_cells[index].sequence.store(index, std::memory_order_relaxed);
+            }
+        }
+
+        ~LogRing() = default;
+
+    public:
+        // Producer side, safe to call from any number of threads
+        bool Push(const uint64_t time, const uint8_t severity, const char level, const char moniker[], const char text[], const bool isTraced = true)
+        {
+            size_t position = m_head.load(std::memory_order_relaxed);
+            Cell* cell;
+
+            while (true) {
+                cell = &m_cells[position & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0) {
+                    if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) == true) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    position = m_head.load(std::memory_order_relaxed);
+                }
+            }
+
+            Record& record = cell->record;
+            record.time = time;
+            record.severity = severity;
+            record.level = level;
+            record.isTraced = isTraced;
+            Copy(record.moniker, MONIKER_SIZE, moniker);
+            const size_t length = Copy(record.text, TEXT_SIZE, text);
+            record.length = static_cast<uint16_t>(length);
+            record.isTruncated = ((text != nullptr) && (text[length] != '\0'));
+            cell->sequence.store(position + 1, std::memory_order_release);
+
+            if (record.isTruncated == true) {
+                m_truncatedRecords.fetch_add(1, std::memory_order_relaxed);
+            }
+            const size_t occupancy = position + 1 - m_tail.load(std::memory_order_relaxed);
+            size_t highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+            while ((occupancy > highWaterMark) && (m_highWaterMark.compare_exchange_weak(highWaterMark, occupancy, std::memory_order_relaxed) == false)) {
+            }
+            m_pushedRecords.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Consumer side. Returns false when the ring is empty, or the oldest record is still being written.
+        bool Pop(Record& record)
+        {
+            const size_t position = m_tail.load(std::memory_order_relaxed);
+            Cell& cell = m_cells[position & m_mask];
+
+            if (cell.sequence.load(std::memory_order_acquire) != (position + 1)) {
+                return false;
+            }
+
+            record = cell.record;
+            cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+            m_tail.store(position + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        bool IsEmpty() const
+        {
+            return (m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire));
+        }
+
+        Statistics Counters() const
+        {
+            Statistics statistics;
+            statistics.capacity = m_mask + 1;
+            statistics.highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+            statistics.pushedRecords = m_pushedRecords.load(std::memory_order_relaxed);
+            statistics.droppedRecords = m_droppedRecords.load(std::memory_order_relaxed);
+            statistics.truncatedRecords = m_truncatedRecords.load(std::memory_order_relaxed);
+            return statistics;
+        }
+
+    private:
+        static constexpr size_t CACHE_LINE = 64;
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            Record record;
+        };
+
+        static size_t Slots(const size_t capacity)
+        {
+            size_t slots = 2;
+            while (slots < capacity) {
+                slots <<= 1;
+            }
+            return slots;
+        }
+
+        // Copies up to size - 1 characters and terminates, returns the number copied
+        static size_t Copy(char destination[], const size_t size, const char source[])
+        {
+            size_t length = 0;
+            if (source != nullptr) {
+                while ((length < (size - 1)) && (source[length] != '\0')) {
+                    length++;
+                }
+                ::memcpy(destination, source, length);
+            }
+            destination[length] = '\0';
+            return length;
+        }
+
+    private:
+        const size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+
+        // Monotonic record positions; the difference is the occupancy. Kept on separate cache lines.
+        uint8_t m_padding0[CACHE_LINE];
+        std::atomic<size_t> m_head;
+        uint8_t m_padding1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> m_tail;
+        uint8_t m_padding2[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+        std::atomic<size_t> m_highWaterMark;
+        std::atomic<uint64_t> m_pushedRecords;
+        std::atomic<uint64_t> m_droppedRecords;
+        std::atomic<uint64_t> m_truncatedRecords;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
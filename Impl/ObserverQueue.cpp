@@ -0,0 +1,190 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ObserverQueue.h"
+
+#include "TraceCategories.h"
+
+#include <algorithm>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    constexpr uint32_t ObserverQueue::BUCKET_LIMITS[];
+    constexpr size_t ObserverQueue::BUCKETS;
+
+    ObserverQueue::ObserverQueue(const std::vector<std::string>& callbacks, const size_t capacity)
+        : m_capacity(capacity)
+        , m_lock()
+        , m_signal()
+        , m_entries()
+        , m_highWaterMark(0)
+        , m_counters()
+        , m_isRunning(true)
+        , m_thread()
+    {
+        for (const std::string& callback : callbacks) {
+            Counters counters = {};
+            counters.name = callback;
+            m_counters.push_back(counters);
+        }
+        m_thread = std::thread(&ObserverQueue::Worker, this);
+    }
+
+    ObserverQueue::~ObserverQueue()
+    {
+        size_t discarded = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_isRunning = false;
+            discarded = m_entries.size();
+            m_entries.clear();
+        }
+        m_signal.notify_one();
+        if (m_thread.joinable() == true) {
+            m_thread.join();
+        }
+        if (discarded > 0) {
+            TRACE_GLOBAL(AVSClient, (_T("Discarded %zu queued observer callbacks"), discarded));
+        }
+    }
+
+    bool ObserverQueue::Submit(const size_t callback, Job&& job)
+    {
+        ASSERT(callback < m_counters.size());
+
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            Counters& counters = m_counters[callback];
+            if ((m_isRunning == true) && (m_entries.size() < m_capacity)) {
+                m_entries.push_back({ callback, std::chrono::steady_clock::now(), std::move(job) });
+                m_highWaterMark = std::max(m_highWaterMark, m_entries.size());
+                counters.calls++;
+                queued = true;
+            } else {
+                counters.dropped++;
+            }
+        }
+
+        if (queued == true) {
+            m_signal.notify_one();
+        } else {
+            TRACE_GLOBAL(AVSClient, (_T("Observer queue full, dropped a %s callback"), m_counters[callback].name.c_str()));
+        }
+
+        return (queued);
+    }
+
+    bool ObserverQueue::SubmitState(const size_t callback, const uint32_t state, Job&& job)
+    {
+        ASSERT(callback < m_counters.size());
+
+        bool accepted = false;
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_isRunning == true) {
+                Counters& counters = m_counters[callback];
+                if ((counters.isStateKnown == true) && (counters.state == state)) {
+                    // Nothing changes, the job submitted last applies this state already
+                    counters.coalesced++;
+                } else {
+                    // Queued behind everything submitted before it, so no transition is skipped or overtaken
+                    m_entries.push_back({ callback, std::chrono::steady_clock::now(), std::move(job) });
+                    m_highWaterMark = std::max(m_highWaterMark, m_entries.size());
+                    counters.state = state;
+                    counters.isStateKnown = true;
+                    queued = true;
+                }
+                counters.calls++;
+                accepted = true;
+            }
+        }
+
+        if (queued == true) {
+            m_signal.notify_one();
+        }
+
+        return (accepted);
+    }
+
+    void ObserverQueue::Statistics(Diagnostics::ObserverStatistics& statistics) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        statistics.Capacity = static_cast<uint32_t>(m_capacity);
+        statistics.Depth = static_cast<uint32_t>(m_entries.size());
+        statistics.HighWaterMark = static_cast<uint32_t>(m_highWaterMark);
+        for (const Counters& counters : m_counters) {
+            Diagnostics::CallbackStatistics& callback = statistics.Callbacks.Add();
+            callback.Callback = counters.name;
+            callback.Calls = counters.calls;
+            callback.Dropped = counters.dropped;
+            callback.Coalesced = counters.coalesced;
+            Report(counters.wait, callback.Wait, callback.MaxWait);
+            Report(counters.run, callback.Run, callback.MaxRun);
+        }
+    }
+
+    void ObserverQueue::Add(Histogram& histogram, const std::chrono::steady_clock::duration duration)
+    {
+        const uint64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        const uint32_t* limit = std::upper_bound(std::begin(BUCKET_LIMITS), std::end(BUCKET_LIMITS), microseconds,
+            [](const uint64_t value, const uint32_t bound) { return (value < bound); });
+
+        histogram.buckets[limit - std::begin(BUCKET_LIMITS)]++;
+        histogram.max = static_cast<uint32_t>(std::max<uint64_t>(histogram.max, std::min<uint64_t>(microseconds, UINT32_MAX)));
+    }
+
+    void ObserverQueue::Report(const Histogram& histogram, Core::JSON::ArrayType<Core::JSON::DecUInt64>& buckets, Core::JSON::DecUInt32& max)
+    {
+        for (const uint64_t count : histogram.buckets) {
+            buckets.Add() = count;
+        }
+        max = histogram.max;
+    }
+
+    void ObserverQueue::Worker()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+
+        while (true) {
+            m_signal.wait(lock, [this]() { return ((m_entries.empty() == false) || (m_isRunning == false)); });
+            if (m_isRunning == false) {
+                break;
+            }
+
+            Entry entry = std::move(m_entries.front());
+            m_entries.pop_front();
+            lock.unlock();
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            entry.job();
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+            lock.lock();
+            Counters& counters = m_counters[entry.callback];
+            Add(counters.wait, start - entry.queued);
+            Add(counters.run, end - start);
+        }
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
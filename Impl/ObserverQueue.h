@@ -0,0 +1,110 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "IAVSDiagnostics.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Bounded queue of work handed off by AVS SDK observer callbacks, run by a thread of its own.
+     *
+     * The SDK calls its observers on its executor threads, so whatever an observer does there,
+     * like posting to VoiceToApps, holds up the SDK. Submit() only queues the work and never
+     * blocks: work that does not fit is dropped and counted. Work that applies a state goes through
+     * SubmitState() instead, which is never dropped and may go beyond the capacity: every change is
+     * queued behind the work submitted before it, only a repeat of the state submitted last for the
+     * same callback is left out. One thread runs the work in the order it was submitted, which keeps
+     * the state changes in order.
+     *
+     * Per callback, the time work waited in the queue and the time it ran are kept in histograms.
+     */
+    class ObserverQueue {
+    public:
+        typedef std::function<void()> Job;
+
+        // Upper bounds of the histogram buckets in microseconds, the last bucket has none
+        static constexpr uint32_t BUCKET_LIMITS[] = { 100, 1000, 10000, 100000, 1000000 };
+        static constexpr size_t BUCKETS = (sizeof(BUCKET_LIMITS) / sizeof(BUCKET_LIMITS[0])) + 1;
+
+        ObserverQueue(const ObserverQueue&) = delete;
+        ObserverQueue& operator=(const ObserverQueue&) = delete;
+
+        // The callbacks are named for the statistics, Submit() refers to them by their index
+        ObserverQueue(const std::vector<std::string>& callbacks, const size_t capacity);
+        ~ObserverQueue();
+
+    public:
+        bool Submit(const size_t callback, Job&& job);
+        // The state identifies what the job applies, a job for an unchanged state is not queued
+        bool SubmitState(const size_t callback, const uint32_t state, Job&& job);
+        void Statistics(Diagnostics::ObserverStatistics& statistics) const;
+
+    private:
+        struct Entry {
+            size_t callback;
+            std::chrono::steady_clock::time_point queued;
+            Job job;
+        };
+
+        struct Histogram {
+            std::array<uint64_t, BUCKETS> buckets;
+            uint32_t max;
+        };
+
+        struct Counters {
+            std::string name;
+            uint64_t calls;
+            uint64_t dropped;
+            uint64_t coalesced;
+            uint32_t state;
+            bool isStateKnown;
+            Histogram wait;
+            Histogram run;
+        };
+
+        static void Add(Histogram& histogram, const std::chrono::steady_clock::duration duration);
+        static void Report(const Histogram& histogram, Core::JSON::ArrayType<Core::JSON::DecUInt64>& buckets, Core::JSON::DecUInt32& max);
+        void Worker();
+
+    private:
+        const size_t m_capacity;
+        mutable std::mutex m_lock;
+        std::condition_variable m_signal;
+        std::deque<Entry> m_entries;
+        size_t m_highWaterMark;
+        std::vector<Counters> m_counters;
+        bool m_isRunning;
+        std::thread m_thread;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,76 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpusVoiceDecoder.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    OpusVoiceDecoder::OpusVoiceDecoder()
+        : m_decoder{ nullptr }
+        , m_channels{ 0 }
+    {
+    }
+
+    OpusVoiceDecoder::~OpusVoiceDecoder()
+    {
+        if (m_decoder != nullptr) {
+            opus_decoder_destroy(m_decoder);
+        }
+    }
+
+    bool OpusVoiceDecoder::Configure(const uint32_t sampleRate, const uint8_t channels)
+    {
+        if (m_decoder != nullptr) {
+            opus_decoder_destroy(m_decoder);
+            m_decoder = nullptr;
+        }
+
+        int error = OPUS_OK;
+        if ((channels == 1) || (channels == 2)) {
+            m_decoder = opus_decoder_create(static_cast<opus_int32>(sampleRate), channels, &error);
+        }
+        m_channels = (m_decoder != nullptr) ? channels : 0;
+
+        return ((m_decoder != nullptr) && (error == OPUS_OK));
+    }
+
+    void OpusVoiceDecoder::Reset()
+    {
+        if (m_decoder != nullptr) {
+            opus_decoder_ctl(m_decoder, OPUS_RESET_STATE);
+        }
+    }
+
+    size_t OpusVoiceDecoder::Decode(const uint8_t data[], const uint16_t length, int16_t output[], const size_t capacity)
+    {
+        size_t produced = 0;
+
+        if ((m_decoder != nullptr) && (length > 0)) {
+            const int frames = opus_decode(m_decoder, data, length, output, static_cast<int>(capacity / m_channels), 0);
+            if (frames > 0) {
+                produced = static_cast<size_t>(frames) * m_channels;
+            }
+        }
+
+        return produced;
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
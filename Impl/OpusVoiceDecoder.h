@@ -0,0 +1,59 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "VoiceDecoder.h"
+
+#include <opus/opus.h>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Opus, one packet per IVoiceHandler::Data() call.
+     *
+     * The decoder runs at the producer's sample rate when libopus supports it directly
+     * (8, 12, 16, 24 or 48 kHz), which covers what voice remotes send.
+     */
+    class OpusVoiceDecoder : public VoiceDecoder {
+    public:
+        OpusVoiceDecoder(const OpusVoiceDecoder&) = delete;
+        OpusVoiceDecoder& operator=(const OpusVoiceDecoder&) = delete;
+
+        OpusVoiceDecoder();
+        ~OpusVoiceDecoder() override;
+
+    public:
+        const char* Name() const override
+        {
+            return ("opus");
+        }
+
+        bool Configure(const uint32_t sampleRate, const uint8_t channels) override;
+        void Reset() override;
+        size_t Decode(const uint8_t data[], const uint16_t length, int16_t output[], const size_t capacity) override;
+
+    private:
+        OpusDecoder* m_decoder;
+        uint8_t m_channels;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
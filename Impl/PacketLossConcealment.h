@@ -0,0 +1,202 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Tracks the sequence numbers of incoming voice packets and fills the holes left by lost ones.
+     *
+     * Works on 16-bit little endian PCM frames. Lost frames are assumed to have the same length
+     * as the packet that revealed the gap.
+     */
+    class PacketLossConcealer {
+    public:
+        enum class Strategy {
+            ZERO,
+            REPEAT,
+            FADE
+        };
+
+        enum class Verdict {
+            IN_ORDER,
+            GAP,
+            LATE,
+            DISCONTINUITY
+        };
+
+        struct Statistics {
+            uint64_t receivedPackets;
+            uint64_t lostPackets;
+            uint64_t latePackets;
+            uint64_t discontinuities;
+        };
+
+        // Gaps longer than this are not concealed but treated as a restart of the sequence
+        static constexpr uint32_t MAX_CONCEALED_GAP = 25;
+        // Number of lost frames over which FADE ramps down to silence
+        static constexpr uint32_t FADE_FRAMES = 4;
+
+        PacketLossConcealer(const PacketLossConcealer&) = delete;
+        PacketLossConcealer& operator=(const PacketLossConcealer&) = delete;
+
+        explicit PacketLossConcealer(const Strategy strategy = Strategy::ZERO)
+            : m_strategy{ strategy }
+            , m_lastFrame()
+            , m_lastLength{ 0 }
+            , m_expected{ 0 }
+            , m_isFirst{ true }
+            , m_isSequenced{ false }
+            , m_statistics()
+        {
+            m_lastFrame.reserve(1024);
+            Reset();
+        }
+
+        ~PacketLossConcealer() = default;
+
+        static bool FromString(const std::string& name, Strategy& strategy)
+        {
+            bool result = true;
+            if ((name.empty() == true) || (name == "zero")) {
+                strategy = Strategy::ZERO;
+            } else if (name == "repeat") {
+                strategy = Strategy::REPEAT;
+            } else if (name == "fade") {
+                strategy = Strategy::FADE;
+            } else {
+                result = false;
+            }
+            return result;
+        }
+
+    public:
+        void Reset()
+        {
+            m_lastLength = 0;
+            m_isFirst = true;
+            m_isSequenced = false;
+            ::memset(&m_statistics, 0, sizeof(m_statistics));
+        }
+
+        /// Classifies a packet. For GAP, missing holds the number of frames to conceal before it.
+        Verdict Track(const uint32_t sequenceNo, uint32_t& missing)
+        {
+            Verdict verdict = Verdict::IN_ORDER;
+            missing = 0;
+
+            if (m_isFirst == true) {
+                m_isFirst = false;
+            } else {
+                const int32_t delta = static_cast<int32_t>(sequenceNo - m_expected);
+
+                if (delta == 0) {
+                    m_isSequenced = true;
+                } else if ((delta == -1) && (m_isSequenced == false)) {
+                    // The producer does not number its packets, nothing to track
+                } else if ((delta > 0) && (static_cast<uint32_t>(delta) <= MAX_CONCEALED_GAP)) {
+                    verdict = Verdict::GAP;
+                    missing = static_cast<uint32_t>(delta);
+                    m_statistics.lostPackets += missing;
+                } else if ((delta < 0) && (static_cast<uint32_t>(-delta) <= MAX_CONCEALED_GAP)) {
+                    verdict = Verdict::LATE;
+                    m_statistics.latePackets++;
+                } else {
+                    verdict = Verdict::DISCONTINUITY;
+                    m_statistics.discontinuities++;
+                }
+            }
+
+            if (verdict != Verdict::LATE) {
+                m_expected = sequenceNo + 1;
+                m_statistics.receivedPackets++;
+            }
+
+            return verdict;
+        }
+
+        /// Produces the index-th (1-based) consecutive lost frame into frame.
+        void Conceal(uint8_t frame[], const uint16_t length, const uint32_t index) const
+        {
+            const uint16_t available = std::min(length, m_lastLength);
+
+            if ((m_strategy == Strategy::ZERO) || (available == 0) || ((m_strategy == Strategy::FADE) && (index > FADE_FRAMES))) {
+                ::memset(frame, 0, length);
+            } else {
+                ::memcpy(frame, m_lastFrame.data(), available);
+                ::memset(&frame[available], 0, length - available);
+
+                if (m_strategy == Strategy::FADE) {
+                    Fade(frame, available, index);
+                }
+            }
+        }
+
+        void Remember(const uint8_t frame[], const uint16_t length)
+        {
+            if (m_strategy != Strategy::ZERO) {
+                if (m_lastFrame.size() < length) {
+                    m_lastFrame.resize(length);
+                }
+                ::memcpy(m_lastFrame.data(), frame, length);
+                m_lastLength = length;
+            }
+        }
+
+        const Statistics& Counters() const
+        {
+            return (m_statistics);
+        }
+
+    private:
+        // Linear ramp from the gain at the end of the previous lost frame to the gain at the end of this one
+        static void Fade(uint8_t frame[], const uint16_t length, const uint32_t index)
+        {
+            const uint32_t samples = length / sizeof(int16_t);
+            const int32_t scale = static_cast<int32_t>(FADE_FRAMES * samples);
+            int32_t remaining = static_cast<int32_t>((FADE_FRAMES - index + 1) * samples);
+
+            for (uint32_t i = 0; i < samples; ++i, --remaining) {
+                const int16_t sample = static_cast<int16_t>(frame[2 * i] | (frame[(2 * i) + 1] << 8));
+                const int16_t faded = static_cast<int16_t>((static_cast<int32_t>(sample) * remaining) / scale);
+                frame[2 * i] = static_cast<uint8_t>(faded & 0xFF);
+                frame[(2 * i) + 1] = static_cast<uint8_t>((faded >> 8) & 0xFF);
+            }
+        }
+
+    private:
+        const Strategy m_strategy;
+        std::vector<uint8_t> m_lastFrame;
+        uint16_t m_lastLength;
+        uint32_t m_expected;
+        bool m_isFirst;
+        bool m_isSequenced;
+        Statistics m_statistics;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -25,32 +25,27 @@
 #include <AVSCommon/Utils/Configuration/ConfigurationNode.h>
 #include <AVSCommon/Utils/Logger/Logger.h>
 
+#include <algorithm>
 #include <memory>
+#include <set>
 
 namespace WPEFramework {
 namespace Plugin {
 
     using namespace alexaClientSDK::avsCommon;
     using namespace alexaClientSDK::avsCommon::avs;
-    using namespace alexaClientSDK::avsCommon::sdkInterfaces;
-    using namespace alexaClientSDK::avsCommon::utils::logger;
 
-    static const size_t HERTZ_PER_KILOHERTZ = 1000;
-    const std::chrono::milliseconds TIMEOUT_FOR_READ_CALLS = std::chrono::milliseconds(1000);
-
-    static const char* DEFAULT_LOCALE = "en-US";
     static const std::string KEY_MODEL_LOCALES = "alexa";
-    static constexpr const char* DETECTION_KEYWORD = "ALEXA";
-    static constexpr const uint32_t DETECTION_TRESHOLD = 200;
+    // Audio a standby decoder hears before it takes over from the active one
+    static constexpr const size_t WARM_UP_SAMPLES = AudioFormatCompatibility::SAMPLE_RATE_HZ;
 
     std::unique_ptr<PryonKeywordDetector> PryonKeywordDetector::create(
         std::shared_ptr<AudioInputStream> stream,
-        utils::AudioFormat audioFormat,
-        std::unordered_set<std::shared_ptr<KeyWordObserverInterface>> keyWordObservers,
-        std::unordered_set<std::shared_ptr<KeyWordDetectorStateObserverInterface>>
-            keyWordDetectorStateObservers,
+        const utils::AudioFormat& audioFormat,
+        const KeyWordObservers& keyWordObservers,
+        const StateObservers& keyWordDetectorStateObservers,
         const std::string& modelsFilePath,
-        std::chrono::milliseconds msToPushPerIteration)
+        const ThreadScheduling& scheduling)
     {
         if (!stream) {
             TRACE_GLOBAL(AVSClient, (_T("Failed to create PryonKeywordDetector: stream is nullptr")));
@@ -62,7 +57,7 @@ namespace Plugin {
         }
 
         std::unique_ptr<PryonKeywordDetector> detector(new PryonKeywordDetector(
-            stream, keyWordObservers, keyWordDetectorStateObservers, audioFormat, msToPushPerIteration));
+            stream, keyWordObservers, keyWordDetectorStateObservers, scheduling));
         if (!detector->Initialize(modelsFilePath)) {
             TRACE_GLOBAL(AVSClient, (_T("Failed to initialize PryonKeywordDetector")));
             return nullptr;
@@ -73,152 +68,289 @@ namespace Plugin {
 
     PryonKeywordDetector::~PryonKeywordDetector()
     {
-        m_isShuttingDown = true;
-        if (m_detectionThread.joinable()) {
-            m_detectionThread.join();
-        }
+        // The decoders go before the base class, which would otherwise still be pushing to them
+        Stop();
+    }
 
-        PryonLiteError error = PryonLiteDecoder_Destroy(&m_decoder);
-        if (error != PRYON_LITE_ERROR_OK) {
+    PryonKeywordDetector::PryonKeywordDetector(
+        std::shared_ptr<AudioInputStream> stream,
+        const KeyWordObservers& keyWordObservers,
+        const StateObservers& keyWordDetectorStateObservers,
+        const ThreadScheduling& scheduling)
+        : KeywordDetector(stream, keyWordObservers, keyWordDetectorStateObservers, scheduling)
+        , m_modelsPath()
+        , m_frameSize{ 1 }
+        , m_decoder()
+        , m_standby()
+        , m_warmUpSamples{ 0 }
+        , m_settingsLock()
+        , m_stagingLock()
+        , m_staged()
+        , m_isStaged{ false }
+        , m_locale()
+        , m_keyword()
+        , m_model()
+    {
+    }
 
-            TRACE(AVSClient, (_T("Failed to destroy PryonLiteDecoder")));
+    PryonKeywordDetector::Decoder::Decoder(PryonKeywordDetector* parent)
+        : parent{ parent }
+        , handle{ nullptr }
+        , config(PryonLiteDecoderConfig_Default)
+        , sessionInfo{}
+        , model()
+        , memory()
+        , locale()
+        , keyword()
+        , isActive{ false }
+        , isSpeech{ false }
+        , pushed{ 0 }
+        , origin{ 0 }
+        , discontinuity{ 0 }
+    {
+    }
+
+    PryonKeywordDetector::Decoder::~Decoder()
+    {
+        if (handle != nullptr) {
+            PryonLiteError error = PryonLiteDecoder_Destroy(&handle);
+            if (error != PRYON_LITE_ERROR_OK) {
+                TRACE_GLOBAL(AVSClient, (_T("Failed to destroy PryonLiteDecoder")));
+            }
         }
+    }
 
-        delete[] m_decoderBuffer;
-        delete[] m_modelBuffer;
+    void PryonKeywordDetector::Decoder::Map(const Index streamIndex)
+    {
+        const Index start = streamIndex - pushed;
+        if (start != origin) {
+            // Audio before the gap is mapped as if it was contiguous with the audio after it, so
+            // boundaries reaching back past the gap are clamped to it
+            origin = start;
+            discontinuity = pushed;
+        }
     }
 
-    PryonKeywordDetector::PryonKeywordDetector(
-        std::shared_ptr<AudioInputStream> stream,
-        std::unordered_set<std::shared_ptr<KeyWordObserverInterface>> keyWordObservers,
-        std::unordered_set<std::shared_ptr<KeyWordDetectorStateObserverInterface>> keyWordDetectorStateObservers,
-        utils::AudioFormat audioFormat,
-        std::chrono::milliseconds msToPushPerIteration)
-        : AbstractKeywordDetector(keyWordObservers, keyWordDetectorStateObservers)
-        , m_isShuttingDown{ false }
-        , m_stream{ stream }
-        , m_streamReader{ nullptr }
-        , m_detectionThread{}
-        , m_maxSamplesPerPush((audioFormat.sampleRateHz / HERTZ_PER_KILOHERTZ) * msToPushPerIteration.count())
-        , m_decoder{ nullptr }
-        , m_config{}
-        , m_sessionInfo{}
-        , m_decoderBuffer{ nullptr }
-        , m_modelBuffer{ nullptr }
+    KeywordDetector::Index PryonKeywordDetector::Decoder::StreamIndex(const long long sampleIndex) const
     {
+        const uint64_t index = (sampleIndex > 0) ? static_cast<uint64_t>(sampleIndex) : 0;
+        return (origin + std::max(index, discontinuity));
     }
 
     bool PryonKeywordDetector::Initialize(const std::string& modelFilePath)
     {
-        m_streamReader = m_stream->createReader(AudioInputStream::Reader::Policy::BLOCKING);
-        if (!m_streamReader) {
-            TRACE(AVSClient, (_T("Failed to initialize PryonKeywordDetector: m_streamReader is nullptr")));
+        m_modelsPath = modelFilePath;
+
+        m_decoder = CreateDecoder(DEFAULT_LOCALE, DEFAULT_KEYWORD);
+        if (!m_decoder) {
             return false;
         }
+        m_decoder->isActive = true;
+
+        m_frameSize = (m_decoder->sessionInfo.samplesPerFrame > 0) ? static_cast<size_t>(m_decoder->sessionInfo.samplesPerFrame) : 1;
+        m_locale = m_decoder->locale;
+        m_keyword = m_decoder->keyword;
+        m_model = m_decoder->model;
 
-        m_config = PryonLiteDecoderConfig_Default;
+        return (Start(m_frameSize));
+    }
 
+    std::unique_ptr<PryonKeywordDetector::Decoder> PryonKeywordDetector::CreateDecoder(const std::string& locale, const std::string& keyword)
+    {
         std::set<std::string> localePaths;
         auto localeToModelsConfig = alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode::getRoot()[KEY_MODEL_LOCALES];
-        bool isLocaleFound = localeToModelsConfig.getStringValues(DEFAULT_LOCALE, &localePaths);
+        bool isLocaleFound = localeToModelsConfig.getStringValues(locale, &localePaths);
         if (!isLocaleFound) {
-            TRACE(AVSClient, (_T("Failed to get default locale from config")));
-            return false;
+            TRACE(AVSClient, (_T("Failed to get locale %s from config"), locale.c_str()));
+            return nullptr;
         }
 
         std::string localizedModelFilepath = "";
         for (auto it = localePaths.cbegin(); it != localePaths.cend(); ++it) {
             if (!it->empty()) {
-                localizedModelFilepath = modelFilePath + "/" + (*it) + ".bin";
+                localizedModelFilepath = m_modelsPath + "/" + (*it) + ".bin";
             }
         }
 
-        WPEFramework::Core::File modelFile(localizedModelFilepath);
-        if (modelFile.Open()) {
-            m_config.sizeofModel = modelFile.Size();
-            m_modelBuffer = new uint8_t[m_config.sizeofModel]();
-            uint32_t nRead = modelFile.Read(m_modelBuffer, m_config.sizeofModel);
-            if (nRead != m_config.sizeofModel) {
-                TRACE(AVSClient, (_T("Failed to read model file")));
-                return false;
-            }
-        } else {
-            TRACE(AVSClient, (_T("Failed to open model file")));
-            return false;
+        std::unique_ptr<Decoder> decoder(new Decoder(this));
+        decoder->locale = locale;
+        decoder->keyword = keyword;
+
+        decoder->model = KeywordModel::Open(localizedModelFilepath);
+        if (!decoder->model) {
+            TRACE(AVSClient, (_T("Failed to load model file")));
+            return nullptr;
         }
-        modelFile.Close();
 
-        m_config.model = m_modelBuffer;
+        decoder->config.model = decoder->model->Data();
+        decoder->config.sizeofModel = decoder->model->Size();
 
         // Query for the size of instance memory required by the decoder
         PryonLiteModelAttributes modelAttributes;
-        PryonLiteError error = PryonLite_GetModelAttributes(m_config.model, m_config.sizeofModel, &modelAttributes);
+        PryonLiteError error = PryonLite_GetModelAttributes(decoder->config.model, decoder->config.sizeofModel, &modelAttributes);
         if (error) {
             TRACE(AVSClient, (_T("Failed to get model attributes from config")));
-            return false;
+            return nullptr;
         }
 
-        m_decoderBuffer = new char[modelAttributes.requiredDecoderMem]();
-        m_config.decoderMem = m_decoderBuffer;
-        m_config.sizeofDecoderMem = modelAttributes.requiredDecoderMem;
-        m_config.userData = reinterpret_cast<void*>(this);
-        m_config.detectThreshold = DETECTION_TRESHOLD;
-        m_config.resultCallback = DetectionCallback;
-        m_config.vadCallback = VadCallback;
-        m_config.useVad = 1;
-
-        error = PryonLiteDecoder_Initialize(&m_config, &m_sessionInfo, &m_decoder);
+        decoder->memory = DecoderArena::Instance().Acquire(modelAttributes.requiredDecoderMem);
+        if (!decoder->memory) {
+            TRACE(AVSClient, (_T("Failed to allocate %zu bytes of decoder memory"), modelAttributes.requiredDecoderMem));
+            return nullptr;
+        }
+        decoder->config.decoderMem = decoder->memory.get();
+        decoder->config.sizeofDecoderMem = modelAttributes.requiredDecoderMem;
+        decoder->config.userData = reinterpret_cast<void*>(decoder.get());
+        decoder->config.detectThreshold = Threshold(keyword);
+        decoder->config.resultCallback = DetectionCallback;
+        decoder->config.vadCallback = VadCallback;
+        decoder->config.useVad = 1;
+
+        error = PryonLiteDecoder_Initialize(&decoder->config, &decoder->sessionInfo, &decoder->handle);
         if (error) {
             TRACE(AVSClient, (_T("Failed to initialize PryonLiteDecoder")));
-            return false;
+            return nullptr;
         }
 
-        error = PryonLiteDecoder_SetDetectionThreshold(m_decoder, DETECTION_KEYWORD, m_config.detectThreshold);
+        error = PryonLiteDecoder_SetDetectionThreshold(decoder->handle, keyword.c_str(), decoder->config.detectThreshold);
         if (error) {
-            TRACE(AVSClient, (_T("Failed to set detection treshold")));
+            TRACE(AVSClient, (_T("Failed to set detection treshold of %s in the %s model"), keyword.c_str(), locale.c_str()));
+            return nullptr;
+        }
+
+        return decoder;
+    }
+
+    bool PryonKeywordDetector::SetLocale(const std::string& locale)
+    {
+        std::lock_guard<std::mutex> settingsLock(m_settingsLock);
+        return (Stage(CreateDecoder(locale, Keyword())));
+    }
+
+    bool PryonKeywordDetector::SetKeyword(const std::string& keyword)
+    {
+        std::lock_guard<std::mutex> settingsLock(m_settingsLock);
+        return (Stage(CreateDecoder(Locale(), ToUpper(keyword))));
+    }
+
+    std::string PryonKeywordDetector::Locale() const
+    {
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        return (m_locale);
+    }
+
+    std::string PryonKeywordDetector::Keyword() const
+    {
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        return (m_keyword);
+    }
+
+    bool PryonKeywordDetector::Stage(std::unique_ptr<Decoder>&& decoder)
+    {
+        if (!decoder) {
+            return false;
+        }
+
+        if (decoder->sessionInfo.samplesPerFrame != static_cast<int>(m_frameSize)) {
+            TRACE(AVSClient, (_T("Model of %s uses frames of %d samples instead of %zu"), decoder->locale.c_str(), decoder->sessionInfo.samplesPerFrame, m_frameSize));
             return false;
         }
 
-        m_isShuttingDown = false;
-        m_detectionThread = std::thread(&PryonKeywordDetector::DetectionLoop, this);
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        m_locale = decoder->locale;
+        m_keyword = decoder->keyword;
+        // A decoder staged earlier and not picked up yet is replaced
+        m_staged = std::move(decoder);
+        m_isStaged = true;
+
         return true;
     }
 
-    void PryonKeywordDetector::DetectionLoop()
-    {
-        std::vector<int16_t> audioDataToPush(m_maxSamplesPerPush);
-        ssize_t wordsRead;
-        bool didErrorOccur = false;
-        PryonLiteError writeStatus = PRYON_LITE_ERROR_OK;
-
-        notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::ACTIVE);
-
-        while (!m_isShuttingDown) {
-            wordsRead = readFromStream(
-                m_streamReader,
-                m_stream,
-                audioDataToPush.data(),
-                audioDataToPush.size(),
-                TIMEOUT_FOR_READ_CALLS,
-                &didErrorOccur);
-
-            if (didErrorOccur) {
-                TRACE(AVSClient, (_T("Overrun in detection loop")));
-                break;
-            } else if (wordsRead > 0) {
-                writeStatus = PryonLiteDecoder_PushAudioSamples(m_decoder, audioDataToPush.data(), audioDataToPush.size());
-                if (writeStatus) {
-                    TRACE(AVSClient, (_T("Error (%d) in detection loop"), writeStatus));
-                    notifyKeyWordDetectorStateObservers(KeyWordDetectorStateObserverInterface::KeyWordDetectorState::ERROR);
-                    break;
+    void PryonKeywordDetector::ApplyThresholds()
+    {
+        Decoder* decoders[] = { m_decoder.get(), m_standby.get() };
+        for (Decoder* decoder : decoders) {
+            if (decoder != nullptr) {
+                const uint32_t threshold = Threshold(decoder->keyword);
+                if (threshold != static_cast<uint32_t>(decoder->config.detectThreshold)) {
+                    const PryonLiteError error = PryonLiteDecoder_SetDetectionThreshold(decoder->handle, decoder->keyword.c_str(), threshold);
+                    if (error) {
+                        TRACE(AVSClient, (_T("Failed to set detection treshold %u of %s"), threshold, decoder->keyword.c_str()));
+                    } else {
+                        TRACE(AVSClient, (_T("Detection threshold of %s is %u"), decoder->keyword.c_str(), threshold));
+                        decoder->config.detectThreshold = threshold;
+                    }
                 }
+            }
+        }
+    }
+
+    bool PryonKeywordDetector::Push(const int16_t samples[], const size_t count, const Index streamIndex)
+    {
+        std::unique_ptr<Decoder> retired;
+        bool isThresholdChanged = IsThresholdChanged();
+
+        if (m_isStaged == true) {
+            std::lock_guard<std::mutex> lock(m_stagingLock);
+            retired = std::move(m_standby);
+            m_standby = std::move(m_staged);
+            m_warmUpSamples = 0;
+            m_isStaged = false;
+            // It may have been created before the latest threshold change
+            isThresholdChanged = true;
+        }
+
+        // The decoder must not be reconfigured while it processes audio
+        if (isThresholdChanged == true) {
+            ApplyThresholds();
+        }
+
+        // The standby decoder hears the same frames as the active one, so it has the full context
+        // of the audio when it takes over and no wake word falls in between.
+        if (m_standby) {
+            m_standby->Map(streamIndex);
+            const PryonLiteError warmUpStatus = PryonLiteDecoder_PushAudioSamples(m_standby->handle, samples, static_cast<int>(count));
+            if (warmUpStatus) {
+                TRACE(AVSClient, (_T("Error (%d) while warming up the %s decoder"), warmUpStatus, m_standby->locale.c_str()));
+                retired = std::move(m_standby);
             } else {
-                TRACE(AVSClient, (_T("Unhandled error in detection loop")));
+                m_standby->pushed += count;
+                m_warmUpSamples += count;
             }
         }
 
-        m_streamReader->close();
-        TRACE_L1(_T("End of detection thread"));
+        m_decoder->Map(streamIndex);
+        const PryonLiteError writeStatus = PryonLiteDecoder_PushAudioSamples(m_decoder->handle, samples, static_cast<int>(count));
+        m_decoder->pushed += count;
+        if (writeStatus) {
+            TRACE(AVSClient, (_T("Error (%d) in detection loop"), writeStatus));
+        }
+
+        if ((m_standby) && (m_warmUpSamples >= WARM_UP_SAMPLES)) {
+            TRACE(AVSClient, (_T("Switching keyword detection to %s in %s"), m_standby->keyword.c_str(), m_standby->locale.c_str()));
+            m_standby->isActive = true;
+            m_decoder->isActive = false;
+            retired = std::move(m_decoder);
+            m_decoder = std::move(m_standby);
+
+            {
+                std::lock_guard<std::mutex> lock(m_stagingLock);
+                m_model = m_decoder->model;
+            }
+            VoiceActivityChanged(m_decoder->isSpeech);
+        }
+
+        return (writeStatus == PRYON_LITE_ERROR_OK);
+    }
+
+    void PryonKeywordDetector::Memory(Diagnostics::MemoryStatistics& statistics) const
+    {
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        if (m_model) {
+            statistics.ModelSize = m_model->Size();
+            statistics.ModelResident = m_model->Resident();
+        }
+        statistics.DecoderSize = DecoderArena::Instance().Size();
     }
 
     /* static */ void PryonKeywordDetector::DetectionCallback(PryonLiteDecoderHandle handle, const PryonLiteResult* result)
@@ -230,24 +362,43 @@ namespace Plugin {
             return;
         }
 
-        const PryonKeywordDetector* pryonKWD = reinterpret_cast<PryonKeywordDetector*>(result->userData);
-        if (!pryonKWD) {
+        const Decoder* decoder = reinterpret_cast<const Decoder*>(result->userData);
+        if (!decoder) {
             TRACE_GLOBAL(AVSClient, (_T("User data is nullptr")));
             return;
         }
 
-        auto sampleLen = result->endSampleIndex - result->beginSampleIndex;
+        if ((decoder->isActive == false) || (decoder->keyword != result->keyword)) {
+            return;
+        }
 
-        pryonKWD->notifyKeyWordObservers(
-            pryonKWD->m_stream,
+        // The sample indices count from the first sample pushed to this decoder. Mapped to the stream
+        // they locate the wake word exactly, wherever the reader is by now.
+        decoder->parent->Detected(
             result->keyword,
-            pryonKWD->m_streamReader->tell() - sampleLen,
-            pryonKWD->m_streamReader->tell());
+            decoder->StreamIndex(result->beginSampleIndex),
+            decoder->StreamIndex(result->endSampleIndex),
+            static_cast<uint32_t>(std::max(result->confidence, 0)));
     }
 
     /* static */ void PryonKeywordDetector::VadCallback(PryonLiteDecoderHandle handle, const PryonLiteVadEvent* vadEvent)
     {
-        TRACE_L1(_T("VadCallback()"));
+        if (!vadEvent) {
+            TRACE_GLOBAL(AVSClient, (_T("VAD event is nullptr")));
+            return;
+        }
+
+        Decoder* decoder = reinterpret_cast<Decoder*>(vadEvent->userData);
+        if (!decoder) {
+            TRACE_GLOBAL(AVSClient, (_T("User data is nullptr")));
+            return;
+        }
+
+        // A standby decoder only keeps track, its state is taken over when it becomes active
+        decoder->isSpeech = (vadEvent->vadState == PRYON_LITE_VAD_ACTIVE);
+        if (decoder->isActive == true) {
+            decoder->parent->VoiceActivityChanged(decoder->isSpeech);
+        }
     }
 
 } // namespace Plugin
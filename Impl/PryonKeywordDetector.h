@@ -19,57 +19,108 @@
 
 #pragma once
 
-#include <AVSCommon/AVS/AudioInputStream.h>
-#include <AVSCommon/SDKInterfaces/KeyWordDetectorStateObserverInterface.h>
-#include <AVSCommon/SDKInterfaces/KeyWordObserverInterface.h>
-#include <AVSCommon/Utils/AudioFormat.h>
-#include <KWD/AbstractKeywordDetector.h>
+#include "KeywordDetector.h"
+#include "KeywordModel.h"
 
 #include "pryon_lite.h"
 
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <thread>
-#include <unordered_set>
 
 namespace WPEFramework {
 namespace Plugin {
 
-    class PryonKeywordDetector : public alexaClientSDK::kwd::AbstractKeywordDetector {
+    class PryonKeywordDetector : public KeywordDetector {
     public:
         static std::unique_ptr<PryonKeywordDetector> create(
             std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream,
-            alexaClientSDK::avsCommon::utils::AudioFormat audioFormat,
-            std::unordered_set<std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordObserverInterface>> keyWordObservers,
-            std::unordered_set<std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordDetectorStateObserverInterface>> keyWordDetectorStateObservers,
+            const alexaClientSDK::avsCommon::utils::AudioFormat& audioFormat,
+            const KeyWordObservers& keyWordObservers,
+            const StateObservers& keyWordDetectorStateObservers,
             const std::string& modelFilePath,
-            std::chrono::milliseconds msToPushPerIteration = std::chrono::milliseconds(10));
+            const ThreadScheduling& scheduling = ThreadScheduling());
 
         ~PryonKeywordDetector() override;
 
+        const char* Name() const override
+        {
+            return ("pryon");
+        }
+
+        // A new locale or keyword is loaded into a standby decoder, which takes over once it has
+        // heard enough audio. Until then the current decoder keeps detecting.
+        bool SetLocale(const std::string& locale) override;
+        bool SetKeyword(const std::string& keyword) override;
+        std::string Locale() const override;
+        std::string Keyword() const override;
+
+        void Memory(Diagnostics::MemoryStatistics& statistics) const override;
+
     private:
+        struct Decoder {
+            Decoder(const Decoder&) = delete;
+            Decoder& operator=(const Decoder&) = delete;
+
+            explicit Decoder(PryonKeywordDetector* parent);
+            ~Decoder();
+
+            // Anchors the next samples pushed to this decoder at the given stream index
+            void Map(const Index streamIndex);
+            // Stream index of a sample index reported by the decoder
+            Index StreamIndex(const long long sampleIndex) const;
+
+            PryonKeywordDetector* const parent;
+            PryonLiteDecoderHandle handle;
+            PryonLiteDecoderConfig config;
+            PryonLiteSessionInfo sessionInfo;
+            std::shared_ptr<const KeywordModel> model;
+            DecoderArena::Block memory;
+            std::string locale;
+            std::string keyword;
+            // Detections of a decoder that is still warming up are not reported
+            std::atomic<bool> isActive;
+            bool isSpeech;
+            // Samples pushed so far, the decoder counts its sample indices from the first of them
+            uint64_t pushed;
+            // Stream index of decoder sample 0, valid from sample index discontinuity on. Audio
+            // skipped after an overrun moves it ahead.
+            Index origin;
+            uint64_t discontinuity;
+        };
+
         PryonKeywordDetector(
             std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream,
-            std::unordered_set<std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordObserverInterface>> keyWordObservers,
-            std::unordered_set<std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordDetectorStateObserverInterface>> keyWordDetectorStateObservers,
-            alexaClientSDK::avsCommon::utils::AudioFormat audioFormat,
-            std::chrono::milliseconds msToPushPerIteration = std::chrono::milliseconds(10));
+            const KeyWordObservers& keyWordObservers,
+            const StateObservers& keyWordDetectorStateObservers,
+            const ThreadScheduling& scheduling);
 
         bool Initialize(const std::string& modelFilePath);
-        void DetectionLoop();
+        std::unique_ptr<Decoder> CreateDecoder(const std::string& locale, const std::string& keyword);
+        void ApplyThresholds();
+        bool Stage(std::unique_ptr<Decoder>&& decoder);
+        bool Push(const int16_t samples[], const size_t count, const Index streamIndex) override;
         static void DetectionCallback(PryonLiteDecoderHandle handle, const PryonLiteResult* result);
         static void VadCallback(PryonLiteDecoderHandle handle, const PryonLiteVadEvent* vadEvent);
 
-        std::atomic<bool> m_isShuttingDown;
-        const std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> m_stream;
-        std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream::Reader> m_streamReader;
-        std::thread m_detectionThread;
-        const size_t m_maxSamplesPerPush;
-        PryonLiteDecoderHandle m_decoder;
-        PryonLiteDecoderConfig m_config;
-        PryonLiteSessionInfo m_sessionInfo;
-        char* m_decoderBuffer;
-        uint8_t* m_modelBuffer;
+        std::string m_modelsPath;
+        size_t m_frameSize;
+
+        // Owned by the detection thread once it runs
+        std::unique_ptr<Decoder> m_decoder;
+        std::unique_ptr<Decoder> m_standby;
+        size_t m_warmUpSamples;
+
+        // Serializes SetLocale() and SetKeyword()
+        std::mutex m_settingsLock;
+        // Guards the hand-over of a staged decoder and the state below
+        mutable std::mutex m_stagingLock;
+        std::unique_ptr<Decoder> m_staged;
+        std::atomic<bool> m_isStaged;
+        std::string m_locale;
+        std::string m_keyword;
+        std::shared_ptr<const KeywordModel> m_model;
     };
 
 } // namespace Plugin
@@ -0,0 +1,495 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReferenceKeywordDetector.h"
+
+#include "Module.h"
+#include "CompatibleAudioFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <limits>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    using namespace alexaClientSDK::avsCommon;
+    using namespace alexaClientSDK::avsCommon::avs;
+
+    constexpr size_t ReferenceKeywordDetector::HOP;
+    constexpr size_t ReferenceKeywordDetector::WINDOW;
+    constexpr size_t ReferenceKeywordDetector::FFT_SIZE;
+    constexpr size_t ReferenceKeywordDetector::BANDS;
+
+    static constexpr const char* TEMPLATES_DIRECTORY = "templates";
+    static constexpr const char* TEMPLATE_EXTENSION = ".raw";
+    static constexpr float PI = 3.14159265358979f;
+    static constexpr float LOWEST_FREQUENCY = 100.0f;
+    static constexpr float HIGHEST_FREQUENCY = 7600.0f;
+    // Range of band energies below the loudest band of a frame that is kept
+    static constexpr float FEATURE_RANGE = 30.0f;
+    // Templates are trimmed to the part louder than their maximum minus this
+    static constexpr float TRIM_RANGE = 25.0f;
+    static constexpr size_t MIN_TEMPLATE_FRAMES = 20;
+    static constexpr size_t MAX_TEMPLATE_FRAMES = 200;
+    // Average distance in dB per frame at which the confidence has dropped to 1000 / e
+    static constexpr float DISTANCE_SCALE = 3.0f;
+    // Frames a match has to stay the best one before it is reported
+    static constexpr uint32_t DECISION_DELAY = 20;
+    // Voice activity: level above the noise floor and frames it lasts after the level drops
+    static constexpr float SPEECH_MARGIN = 12.0f;
+    static constexpr uint32_t HANGOVER = 30;
+    static constexpr float INFINITE_COST = std::numeric_limits<float>::max();
+
+    static float Mel(const float frequency)
+    {
+        return (2595.0f * std::log10(1.0f + (frequency / 700.0f)));
+    }
+
+    static float Frequency(const float mel)
+    {
+        return (700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f));
+    }
+
+    std::unique_ptr<ReferenceKeywordDetector> ReferenceKeywordDetector::create(
+        std::shared_ptr<AudioInputStream> stream,
+        const utils::AudioFormat& audioFormat,
+        const KeyWordObservers& keyWordObservers,
+        const StateObservers& keyWordDetectorStateObservers,
+        const std::string& modelsPath,
+        const ThreadScheduling& scheduling)
+    {
+        if (!stream) {
+            TRACE_GLOBAL(AVSClient, (_T("Failed to create ReferenceKeywordDetector: stream is nullptr")));
+            return nullptr;
+        }
+
+        if (!AudioFormatCompatibility::IsCompatible(audioFormat)) {
+            return nullptr;
+        }
+
+        std::unique_ptr<ReferenceKeywordDetector> detector(new ReferenceKeywordDetector(
+            stream, keyWordObservers, keyWordDetectorStateObservers, scheduling));
+        if (!detector->Initialize(modelsPath)) {
+            TRACE_GLOBAL(AVSClient, (_T("Failed to initialize ReferenceKeywordDetector")));
+            return nullptr;
+        }
+
+        return detector;
+    }
+
+    ReferenceKeywordDetector::ReferenceKeywordDetector(
+        std::shared_ptr<AudioInputStream> stream,
+        const KeyWordObservers& keyWordObservers,
+        const StateObservers& keyWordDetectorStateObservers,
+        const ThreadScheduling& scheduling)
+        : KeywordDetector(stream, keyWordObservers, keyWordDetectorStateObservers, scheduling)
+        , m_modelsPath()
+        , m_analyser()
+        , m_active()
+        , m_matchers()
+        , m_candidate{ 0, 0, 0, 0 }
+        , m_isMatching{ false }
+        , m_next{ 0 }
+        , m_threshold{ DEFAULT_THRESHOLD }
+        , m_activity(SPEECH_MARGIN, 1, HANGOVER)
+        , m_settingsLock()
+        , m_stagingLock()
+        , m_staged()
+        , m_isStaged{ false }
+        , m_locale()
+        , m_keyword()
+        , m_model()
+    {
+    }
+
+    ReferenceKeywordDetector::~ReferenceKeywordDetector()
+    {
+        // The templates go before the base class, which would otherwise still be pushing audio
+        Stop();
+    }
+
+    bool ReferenceKeywordDetector::Initialize(const std::string& modelsPath)
+    {
+        m_modelsPath = modelsPath;
+
+        std::shared_ptr<const Model> model = Load(DEFAULT_LOCALE, DEFAULT_KEYWORD);
+        if (!model) {
+            return false;
+        }
+
+        m_locale = model->locale;
+        m_keyword = model->keyword;
+        m_model = model;
+        Adopt(model);
+
+        return (Start(HOP));
+    }
+
+    std::shared_ptr<const ReferenceKeywordDetector::Model> ReferenceKeywordDetector::Load(const std::string& locale, const std::string& keyword) const
+    {
+        const std::string directory = m_modelsPath + "/" + TEMPLATES_DIRECTORY + "/" + locale;
+        DIR* templates = ::opendir(directory.c_str());
+        if (templates == nullptr) {
+            TRACE(AVSClient, (_T("No keyword templates for locale %s in %s"), locale.c_str(), directory.c_str()));
+            return nullptr;
+        }
+
+        std::shared_ptr<Model> model(new Model());
+        model->locale = locale;
+        model->keyword = keyword;
+        model->size = 0;
+
+        Analyser analyser;
+        struct dirent* entry;
+        while ((entry = ::readdir(templates)) != nullptr) {
+            const std::string name(entry->d_name);
+            const size_t extension = name.rfind(TEMPLATE_EXTENSION);
+            if ((extension == std::string::npos) || ((extension + ::strlen(TEMPLATE_EXTENSION)) != name.size())
+                || (ToUpper(name.substr(0, std::min(extension, name.find('-')))) != keyword)) {
+                continue;
+            }
+
+            std::ifstream file(directory + "/" + name, std::ios::binary);
+            int16_t hop[HOP];
+            std::vector<Feature> frames;
+            std::vector<float> energies;
+            analyser.Reset();
+            while (file.read(reinterpret_cast<char*>(hop), sizeof(hop))) {
+                Feature feature;
+                energies.push_back(analyser.Frame(hop, feature));
+                frames.push_back(feature);
+            }
+
+            // Leading and trailing silence would only dilute the distance
+            const float loudest = (energies.empty() == true) ? 0.0f : *std::max_element(energies.begin(), energies.end());
+            size_t first = 0;
+            size_t last = energies.size();
+            while ((first < last) && (energies[first] < (loudest - TRIM_RANGE))) {
+                first++;
+            }
+            while ((last > first) && (energies[last - 1] < (loudest - TRIM_RANGE))) {
+                last--;
+            }
+
+            if (((last - first) < MIN_TEMPLATE_FRAMES) || ((last - first) > MAX_TEMPLATE_FRAMES)) {
+                TRACE(AVSClient, (_T("Keyword template %s has %zu frames of speech, skipped"), name.c_str(), last - first));
+                continue;
+            }
+
+            model->templates.emplace_back(frames.begin() + first, frames.begin() + last);
+            model->size += (last - first) * sizeof(Feature);
+        }
+        ::closedir(templates);
+
+        if (model->templates.empty() == true) {
+            TRACE(AVSClient, (_T("No usable templates of %s in %s"), keyword.c_str(), directory.c_str()));
+            return nullptr;
+        }
+
+        TRACE(AVSClient, (_T("Loaded %zu templates of %s in %s"), model->templates.size(), keyword.c_str(), locale.c_str()));
+        return (model);
+    }
+
+    bool ReferenceKeywordDetector::SetLocale(const std::string& locale)
+    {
+        std::lock_guard<std::mutex> settingsLock(m_settingsLock);
+        return (Stage(Load(locale, Keyword())));
+    }
+
+    bool ReferenceKeywordDetector::SetKeyword(const std::string& keyword)
+    {
+        std::lock_guard<std::mutex> settingsLock(m_settingsLock);
+        return (Stage(Load(Locale(), ToUpper(keyword))));
+    }
+
+    std::string ReferenceKeywordDetector::Locale() const
+    {
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        return (m_locale);
+    }
+
+    std::string ReferenceKeywordDetector::Keyword() const
+    {
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        return (m_keyword);
+    }
+
+    bool ReferenceKeywordDetector::Stage(std::shared_ptr<const Model>&& model)
+    {
+        if (!model) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        m_locale = model->locale;
+        m_keyword = model->keyword;
+        m_model = model;
+        // Templates staged earlier and not picked up yet are replaced
+        m_staged = std::move(model);
+        m_isStaged = true;
+
+        return true;
+    }
+
+    void ReferenceKeywordDetector::Memory(Diagnostics::MemoryStatistics& statistics) const
+    {
+        std::lock_guard<std::mutex> lock(m_stagingLock);
+        if (m_model) {
+            statistics.ModelSize = m_model->size;
+            statistics.ModelResident = m_model->size;
+        }
+    }
+
+    void ReferenceKeywordDetector::Adopt(const std::shared_ptr<const Model>& model)
+    {
+        m_matchers.clear();
+        m_active = model;
+        for (const std::vector<Feature>& frames : m_active->templates) {
+            m_matchers.emplace_back(frames);
+        }
+        m_threshold = Threshold(m_active->keyword);
+        Reset();
+    }
+
+    void ReferenceKeywordDetector::Reset()
+    {
+        for (Matcher& matcher : m_matchers) {
+            matcher.Reset();
+        }
+        m_candidate.confidence = 0;
+        m_isMatching = false;
+    }
+
+    bool ReferenceKeywordDetector::Push(const int16_t samples[], const size_t count, const Index streamIndex)
+    {
+        if (m_isStaged == true) {
+            std::shared_ptr<const Model> model;
+            {
+                std::lock_guard<std::mutex> lock(m_stagingLock);
+                model = std::move(m_staged);
+                m_isStaged = false;
+            }
+            TRACE(AVSClient, (_T("Switching keyword detection to %s in %s"), model->keyword.c_str(), model->locale.c_str()));
+            Adopt(model);
+        } else if (IsThresholdChanged() == true) {
+            m_threshold = Threshold(m_active->keyword);
+        }
+
+        // A match cannot span audio skipped after an overrun
+        if (streamIndex != m_next) {
+            m_analyser.Reset();
+            Reset();
+        }
+        m_next = streamIndex + count;
+
+        for (size_t offset = 0; (offset + HOP) <= count; offset += HOP) {
+            const Index frameStart = streamIndex + offset;
+            Feature feature;
+            const bool isSpeech = m_activity.Process(m_analyser.Frame(&samples[offset], feature));
+
+            if ((isSpeech == true) || (m_candidate.confidence > 0)) {
+                m_isMatching = true;
+                for (Matcher& matcher : m_matchers) {
+                    Index begin;
+                    const float distance = matcher.Step(feature, frameStart, begin);
+                    if (distance < INFINITE_COST) {
+                        const uint32_t confidence = static_cast<uint32_t>(MAX_THRESHOLD * std::exp(-distance / DISTANCE_SCALE));
+                        if ((confidence >= m_threshold) && (confidence > m_candidate.confidence)) {
+                            m_candidate = { confidence, begin, frameStart + HOP, 0 };
+                        }
+                    }
+                }
+
+                if ((m_candidate.confidence > 0) && (++m_candidate.age >= DECISION_DELAY)) {
+                    Detected(m_active->keyword, m_candidate.begin, m_candidate.end, m_candidate.confidence);
+                    Reset();
+                }
+            } else if (m_isMatching == true) {
+                // Paths do not survive silence, of any template, whatever their cost
+                Reset();
+            }
+
+            VoiceActivityChanged(isSpeech);
+        }
+
+        return true;
+    }
+
+    /* static */ float ReferenceKeywordDetector::Distance(const Feature& a, const Feature& b)
+    {
+        float sum = 0.0f;
+        for (size_t band = 0; band < BANDS; band++) {
+            const float difference = a[band] - b[band];
+            sum += difference * difference;
+        }
+        return (std::sqrt(sum / BANDS));
+    }
+
+    ReferenceKeywordDetector::Matcher::Matcher(const std::vector<Feature>& frames)
+        : frames(frames)
+        , cost(frames.size(), INFINITE_COST)
+        , start(frames.size(), 0)
+        , length(frames.size(), 0)
+        , nextCost(frames.size(), INFINITE_COST)
+        , nextStart(frames.size(), 0)
+        , nextLength(frames.size(), 0)
+    {
+    }
+
+    void ReferenceKeywordDetector::Matcher::Reset()
+    {
+        std::fill(cost.begin(), cost.end(), INFINITE_COST);
+    }
+
+    float ReferenceKeywordDetector::Matcher::Step(const Feature& feature, const Index frameStart, Index& begin)
+    {
+        // A path may start at any frame of the stream. It advances one template frame per stream
+        // frame, stays on a template frame, or skips one, i.e. speech at half to any speed.
+        for (size_t j = 0; j < frames.size(); j++) {
+            float best = INFINITE_COST;
+            size_t from = 0;
+            if (j == 0) {
+                best = 0.0f;
+            } else {
+                const size_t candidates[] = { j - 1, j, (j >= 2) ? (j - 2) : (j - 1) };
+                for (const size_t candidate : candidates) {
+                    if (cost[candidate] < best) {
+                        best = cost[candidate];
+                        from = candidate;
+                    }
+                }
+            }
+
+            if (best == INFINITE_COST) {
+                nextCost[j] = INFINITE_COST;
+            } else {
+                nextCost[j] = best + Distance(feature, frames[j]);
+                nextStart[j] = (j == 0) ? frameStart : start[from];
+                nextLength[j] = (j == 0) ? 1 : (length[from] + 1);
+            }
+        }
+
+        cost.swap(nextCost);
+        start.swap(nextStart);
+        length.swap(nextLength);
+
+        begin = start.back();
+        return ((cost.back() < INFINITE_COST) ? (cost.back() / length.back()) : INFINITE_COST);
+    }
+
+    ReferenceKeywordDetector::Analyser::Analyser()
+        : m_window(WINDOW)
+        , m_twiddles(FFT_SIZE / 2)
+        , m_spectrum(FFT_SIZE)
+        , m_firstBin()
+        , m_weights()
+        , m_history(WINDOW, 0)
+    {
+        for (size_t n = 0; n < WINDOW; n++) {
+            m_window[n] = 0.5f - (0.5f * std::cos((2.0f * PI * n) / (WINDOW - 1)));
+        }
+        for (size_t k = 0; k < (FFT_SIZE / 2); k++) {
+            m_twiddles[k] = std::polar(1.0f, (-2.0f * PI * k) / FFT_SIZE);
+        }
+
+        // BANDS triangles evenly spaced on the mel scale, each reaching to the centres of its neighbours
+        const float lowest = Mel(LOWEST_FREQUENCY);
+        const float step = (Mel(HIGHEST_FREQUENCY) - lowest) / (BANDS + 1);
+        const float binWidth = static_cast<float>(AudioFormatCompatibility::SAMPLE_RATE_HZ) / FFT_SIZE;
+        for (size_t band = 0; band < BANDS; band++) {
+            const float left = Frequency(lowest + (band * step)) / binWidth;
+            const float centre = Frequency(lowest + ((band + 1) * step)) / binWidth;
+            const float right = Frequency(lowest + ((band + 2) * step)) / binWidth;
+            m_firstBin[band] = static_cast<size_t>(std::ceil(left));
+            for (size_t bin = m_firstBin[band]; bin < right; bin++) {
+                m_weights[band].push_back((bin < centre) ? ((bin - left) / (centre - left)) : ((right - bin) / (right - centre)));
+            }
+        }
+    }
+
+    void ReferenceKeywordDetector::Analyser::Reset()
+    {
+        std::fill(m_history.begin(), m_history.end(), 0);
+    }
+
+    float ReferenceKeywordDetector::Analyser::Frame(const int16_t hop[], Feature& feature)
+    {
+        ::memmove(m_history.data(), &m_history[HOP], (WINDOW - HOP) * sizeof(int16_t));
+        ::memcpy(&m_history[WINDOW - HOP], hop, HOP * sizeof(int16_t));
+
+        for (size_t n = 0; n < WINDOW; n++) {
+            m_spectrum[n] = m_history[n] * m_window[n];
+        }
+        std::fill(m_spectrum.begin() + WINDOW, m_spectrum.end(), 0.0f);
+        Transform();
+
+        for (size_t band = 0; band < BANDS; band++) {
+            float energy = 1.0f;
+            for (size_t i = 0; i < m_weights[band].size(); i++) {
+                energy += m_weights[band][i] * std::norm(m_spectrum[m_firstBin[band] + i]);
+            }
+            feature[band] = 10.0f * std::log10(energy);
+        }
+
+        // Bands far below the loudest one carry noise rather than the word
+        const float floor = *std::max_element(feature.begin(), feature.end()) - FEATURE_RANGE;
+        float mean = 0.0f;
+        for (float& value : feature) {
+            value = std::max(value, floor);
+            mean += value;
+        }
+        mean /= BANDS;
+        for (float& value : feature) {
+            value -= mean;
+        }
+
+        return (EnergyDetector::Level(hop, HOP));
+    }
+
+    void ReferenceKeywordDetector::Analyser::Transform()
+    {
+        // Iterative radix-2 FFT, in place
+        for (size_t i = 1, j = 0; i < FFT_SIZE; i++) {
+            size_t bit = FFT_SIZE >> 1;
+            for (; (j & bit) != 0; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(m_spectrum[i], m_spectrum[j]);
+            }
+        }
+        for (size_t size = 2; size <= FFT_SIZE; size <<= 1) {
+            const size_t stride = FFT_SIZE / size;
+            for (size_t first = 0; first < FFT_SIZE; first += size) {
+                for (size_t k = 0; k < (size / 2); k++) {
+                    const std::complex<float> odd = m_twiddles[k * stride] * m_spectrum[first + k + (size / 2)];
+                    m_spectrum[first + k + (size / 2)] = m_spectrum[first + k] - odd;
+                    m_spectrum[first + k] += odd;
+                }
+            }
+        }
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
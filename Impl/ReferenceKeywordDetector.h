@@ -0,0 +1,172 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "EnergyDetector.h"
+#include "KeywordDetector.h"
+
+#include <array>
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Keyword detector without a vendor library, matching the audio against recordings of the
+     * keyword (templates).
+     *
+     * Templates are 16 kHz, 16 bit, mono raw PCM files named <modelsPath>/templates/<locale>/<KEYWORD>[-n].raw.
+     * Every 10 ms of audio becomes a vector of log mel band energies, normalised to its mean so
+     * the level of the speaker does not matter. An energy based voice activity detector gates a
+     * streaming subsequence DTW against every template of the keyword; a match that stays best
+     * for DECISION_DELAY is reported with confidence 1000 * exp(-distance / DISTANCE_SCALE).
+     */
+    class ReferenceKeywordDetector : public KeywordDetector {
+    public:
+        static std::unique_ptr<ReferenceKeywordDetector> create(
+            std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream,
+            const alexaClientSDK::avsCommon::utils::AudioFormat& audioFormat,
+            const KeyWordObservers& keyWordObservers,
+            const StateObservers& keyWordDetectorStateObservers,
+            const std::string& modelsPath,
+            const ThreadScheduling& scheduling = ThreadScheduling());
+
+        ~ReferenceKeywordDetector() override;
+
+        const char* Name() const override
+        {
+            return ("reference");
+        }
+
+        // The templates of a new locale or keyword are loaded by the caller and matched from the
+        // next push on
+        bool SetLocale(const std::string& locale) override;
+        bool SetKeyword(const std::string& keyword) override;
+        std::string Locale() const override;
+        std::string Keyword() const override;
+
+        void Memory(Diagnostics::MemoryStatistics& statistics) const override;
+
+    private:
+        static constexpr size_t HOP = 160;
+        static constexpr size_t WINDOW = 400;
+        static constexpr size_t FFT_SIZE = 512;
+        static constexpr size_t BANDS = 20;
+
+        using Feature = std::array<float, BANDS>;
+
+        // Log mel band energies of the last WINDOW samples, one frame per HOP samples
+        class Analyser {
+        public:
+            Analyser();
+
+            void Reset();
+            // Returns the energy of the hop in dB
+            float Frame(const int16_t hop[], Feature& feature);
+
+        private:
+            void Transform();
+
+            std::vector<float> m_window;
+            std::vector<std::complex<float>> m_twiddles;
+            std::vector<std::complex<float>> m_spectrum;
+            // Triangular mel filters as first bin and weights per band
+            std::array<size_t, BANDS> m_firstBin;
+            std::array<std::vector<float>, BANDS> m_weights;
+            std::vector<int16_t> m_history;
+        };
+
+        struct Model {
+            std::string locale;
+            std::string keyword;
+            std::vector<std::vector<Feature>> templates;
+            size_t size;
+        };
+
+        // Streaming subsequence DTW of one template: the last column of the accumulated distances,
+        // with the stream index and length of the best path into every cell
+        struct Matcher {
+            explicit Matcher(const std::vector<Feature>& frames);
+
+            void Reset();
+            // Returns the average distance of the best match ending at this frame
+            float Step(const Feature& feature, const Index frameStart, Index& begin);
+
+            const std::vector<Feature>& frames;
+            std::vector<float> cost;
+            std::vector<Index> start;
+            std::vector<uint32_t> length;
+            std::vector<float> nextCost;
+            std::vector<Index> nextStart;
+            std::vector<uint32_t> nextLength;
+        };
+
+        struct Candidate {
+            uint32_t confidence;
+            Index begin;
+            Index end;
+            uint32_t age;
+        };
+
+        ReferenceKeywordDetector(
+            std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream,
+            const KeyWordObservers& keyWordObservers,
+            const StateObservers& keyWordDetectorStateObservers,
+            const ThreadScheduling& scheduling);
+
+        bool Initialize(const std::string& modelsPath);
+        std::shared_ptr<const Model> Load(const std::string& locale, const std::string& keyword) const;
+        bool Stage(std::shared_ptr<const Model>&& model);
+        void Adopt(const std::shared_ptr<const Model>& model);
+        void Reset();
+        bool Push(const int16_t samples[], const size_t count, const Index streamIndex) override;
+        static float Distance(const Feature& a, const Feature& b);
+
+        std::string m_modelsPath;
+
+        // Owned by the detection thread once it runs
+        Analyser m_analyser;
+        std::shared_ptr<const Model> m_active;
+        std::vector<Matcher> m_matchers;
+        Candidate m_candidate;
+        // Set once the matchers stepped, cleared by Reset()
+        bool m_isMatching;
+        Index m_next;
+        uint32_t m_threshold;
+        EnergyDetector m_activity;
+
+        // Serializes SetLocale() and SetKeyword()
+        std::mutex m_settingsLock;
+        // Guards the hand-over of staged templates and the state below
+        mutable std::mutex m_stagingLock;
+        std::shared_ptr<const Model> m_staged;
+        std::atomic<bool> m_isStaged;
+        std::string m_locale;
+        std::string m_keyword;
+        std::shared_ptr<const Model> m_model;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,98 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+#include "AudioStagingRing.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Memory mapped ring through which an out-of-process voice producer hands over its packets
+     * without a COM-RPC call per packet.
+     *
+     * The mapping is a Core::CyclicBuffer created by the AVS implementation at the configured path;
+     * the producer opens the same file. Each record is an AudioStagingRing::Header (sequence number,
+     * payload length, flags, little endian) followed by the payload, written with a single Write()
+     * so that a record is never seen partially. Waking the consumer is left to the buffer's own
+     * process-shared signalling, nothing else crosses the process boundary.
+     */
+    class SharedAudioChannel {
+    public:
+        SharedAudioChannel(const SharedAudioChannel&) = delete;
+        SharedAudioChannel& operator=(const SharedAudioChannel&) = delete;
+
+        SharedAudioChannel(const string& path, const uint32_t size)
+            : m_buffer(path, Core::File::USER_READ | Core::File::USER_WRITE | Core::File::GROUP_READ | Core::File::GROUP_WRITE | Core::File::SHAREABLE | Core::File::CREATE, size, false)
+        {
+        }
+
+        ~SharedAudioChannel() = default;
+
+    public:
+        bool IsValid() const
+        {
+            return (m_buffer.IsValid());
+        }
+
+        bool IsReady() const
+        {
+            return (m_buffer.Used() >= sizeof(AudioStagingRing::Header));
+        }
+
+        /// Waits at most waitTime milliseconds for a complete record.
+        bool Wait(const uint32_t waitTime)
+        {
+            bool available = IsReady();
+
+            if ((available == false) && (m_buffer.Lock(true, waitTime) == Core::ERROR_NONE)) {
+                m_buffer.Unlock();
+                available = IsReady();
+            }
+
+            return available;
+        }
+
+        bool Pop(AudioStagingRing::Header& header, uint8_t data[], const uint16_t maxLength)
+        {
+            if ((maxLength == 0) || (m_buffer.Used() < sizeof(header))) {
+                return false;
+            }
+
+            m_buffer.Read(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+
+            uint16_t remaining = header.length;
+            while (remaining > 0) {
+                // Payloads that do not fit are consumed and dropped, so the next record stays aligned
+                const uint16_t chunk = std::min(remaining, maxLength);
+                m_buffer.Read(data, chunk);
+                remaining -= chunk;
+            }
+
+            return (header.length <= maxLength);
+        }
+
+    private:
+        Core::CyclicBuffer m_buffer;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
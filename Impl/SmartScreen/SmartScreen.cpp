@@ -19,9 +19,6 @@
 
 #include "SmartScreen.h"
 
-#if defined(KWD_PRYON)
-#include "PryonKeywordDetector.h"
-#endif
 #include "ThunderLogger.h"
 #include "ThunderVoiceHandler.h"
 #include "TraceCategories.h"
@@ -112,6 +109,10 @@ namespace Plugin {
 
     SERVICE_REGISTRATION(SmartScreen, 1, 0);
 
+    constexpr size_t SmartScreen::KEYWORD_QUEUE_SIZE;
+    // Named after the KeywordCallback they are indexed by
+    const std::vector<std::string> SmartScreen::KEYWORD_CALLBACKS = { "voiceactivity", "keyworddetected" };
+
     using namespace alexaClientSDK;
 
     // Alexa Client Config keys
@@ -138,15 +139,15 @@ namespace Plugin {
      
     
     // Share Data stream Configuraiton
-    static const size_t MAX_READERS = 10;
-    static const size_t WORD_SIZE = 2;
     static const unsigned int SAMPLE_RATE_HZ = 16000;
     static const unsigned int NUM_CHANNELS = 1;
-    static const std::chrono::seconds AMOUNT_OF_AUDIO_DATA_IN_BUFFER = std::chrono::seconds(15);
-    static const size_t BUFFER_SIZE_IN_SAMPLES = (SAMPLE_RATE_HZ)*AMOUNT_OF_AUDIO_DATA_IN_BUFFER.count();
 
     // Thunder voice handler
     static constexpr const char* PORTAUDIO_CALLSIGN("PORTAUDIO");
+    // Pre-roll must stay well inside the audio kept by the shared data stream
+    static const std::chrono::milliseconds MAX_VOICE_PRE_ROLL = std::chrono::milliseconds(2000);
+    // Flight recorder of the SDK logs, in the persistent path
+    static constexpr const char* FLIGHT_RECORDER_FILE("flightrecorder.bin");
 
     // smart screein
     static const std::string WEBSOCKET_INTERFACE_KEY("websocketInterface");
@@ -173,7 +174,7 @@ namespace Plugin {
             TRACE(AVSClient, (_T("Missing log level")));
             status = false;
         } else {
-            status = InitSDKLogs(logLevel);
+            status = InitSDKLogs(logLevel, config.LogLevels.Value(), config.RecorderLevel.Value(), config.RecorderSize.Value());
         }
 
         const std::string alexaClientConfig = config.AlexaClientConfig.Value();
@@ -200,12 +201,72 @@ namespace Plugin {
             status = false;
         }
 
+        if ((status == true) && (PacketLossConcealer::FromString(config.VoiceConcealment.Value(), m_voiceSettings.concealment) == false)) {
+            TRACE(AVSClient, (_T("Unknown voice concealment strategy")));
+            status = false;
+        }
+
+        if ((status == true) && (config.VoiceDecoder.IsSet() == true)) {
+            m_voiceSettings.decoder = config.VoiceDecoder.Value();
+        }
+        if ((status == true) && (!VoiceDecoder::Create(m_voiceSettings.decoder))) {
+            TRACE(AVSClient, (_T("Voice decoder %s is not available"), m_voiceSettings.decoder.c_str()));
+            status = false;
+        }
+
+        if ((status == true) && (config.VoicePreRoll.Value() > MAX_VOICE_PRE_ROLL.count())) {
+            TRACE(AVSClient, (_T("Voice pre-roll is limited to %lld ms"), static_cast<long long>(MAX_VOICE_PRE_ROLL.count())));
+            status = false;
+        }
+        m_voiceSettings.preRoll = std::chrono::milliseconds(config.VoicePreRoll.Value());
+        m_voiceSettings.channel = config.VoiceChannel.Value();
+        if ((status == true) && (config.VoiceThread.Get(m_voiceSettings.scheduling) == false)) {
+            TRACE(AVSClient, (_T("Invalid scheduling of the voice thread")));
+            status = false;
+        }
+
+        if (config.StreamReaders.IsSet() == true) {
+            m_streamSettings.readers = config.StreamReaders.Value();
+        }
+        if (config.StreamDuration.IsSet() == true) {
+            m_streamSettings.duration = std::chrono::seconds(config.StreamDuration.Value());
+        }
+        if (config.StreamWordSize.IsSet() == true) {
+            m_streamSettings.wordSize = config.StreamWordSize.Value();
+        }
+        m_streamSettings.lock = config.StreamLock.Value();
+        m_streamSettings.hugePages = config.StreamHugePages.Value();
+
+        if ((status == true) && (m_streamSettings.readers == 0)) {
+            TRACE(AVSClient, (_T("The shared data stream needs at least one reader")));
+            status = false;
+        }
+        if ((status == true) && (m_streamSettings.duration <= m_voiceSettings.preRoll)) {
+            TRACE(AVSClient, (_T("The shared data stream must hold more audio than the voice pre-roll")));
+            status = false;
+        }
+        if ((status == true) && ((m_streamSettings.wordSize * CHAR_BIT) != AudioFormatCompatibility::SAMPLE_SIZE_IN_BITS)) {
+            TRACE(AVSClient, (_T("Shared data stream word size of %zu bytes does not match the %u bit audio format"), m_streamSettings.wordSize, AudioFormatCompatibility::SAMPLE_SIZE_IN_BITS));
+            status = false;
+        }
+
         const bool enableKWD = config.EnableKWD.Value();
-        if (enableKWD == true) {
-#if !defined(KWD_PRYON)
-            TRACE(AVSClient, (_T("Requested KWD, but it is not compiled in")));
+        m_keywordThresholds = config.KWDThresholds.Value();
+        m_keywordCascade = config.KWDCascade.Value();
+        if ((status == true) && (config.KWDThread.Get(m_keywordScheduling) == false)) {
+            TRACE(AVSClient, (_T("Invalid scheduling of the keyword detection thread")));
+            status = false;
+        }
+        if ((status == true) && (config.VTADispatcher.Get(m_dispatcherSettings) == false)) {
+            TRACE(AVSClient, (_T("Invalid settings of the VoiceToApps HTTP dispatcher")));
+            status = false;
+        }
+        if (config.KWDEngine.IsSet() == true) {
+            m_keywordEngine = config.KWDEngine.Value();
+        }
+        if ((status == true) && (enableKWD == true) && (KeywordDetector::IsAvailable(m_keywordEngine) == false)) {
+            TRACE(AVSClient, (_T("Requested KWD, but the %s engine is not compiled in"), m_keywordEngine.c_str()));
             status = false;
-#endif
         }
 
     if (status == true) {
@@ -236,9 +297,9 @@ namespace Plugin {
         }
         jsonConfig->push_back(ssConfig);
 
-#if defined(KWD_PRYON)
-    if (enableKWD) {
-        auto localeToModelsConfig = pathToInputFolder + "/localeToModels.json";
+    const std::string keywordConfiguration = KeywordDetector::Configuration(m_keywordEngine);
+    if ((enableKWD) && (keywordConfiguration.empty() == false)) {
+        auto localeToModelsConfig = pathToInputFolder + "/" + keywordConfiguration;
         auto ltmConfigInFile = std::shared_ptr<std::ifstream>(new std::ifstream(localeToModelsConfig));
         if (!ltmConfigInFile->good()) {
             TRACE(AVSClient, (_T("Failed to read ltm appConfig file filename")));
@@ -246,7 +307,6 @@ namespace Plugin {
         }
         jsonConfig->push_back(ltmConfigInFile);
     }
-#endif
     auto avsBuilder = alexaClientSDK::avsCommon::avs::initialization::InitializationParametersBuilder::create();
     avsBuilder->withJsonStreams(jsonConfig);
     if (!avsBuilder) {
@@ -517,11 +577,7 @@ namespace Plugin {
         nullptr,
         nullptr);
     
-    size_t bufferSize = alexaClientSDK::avsCommon::avs::AudioInputStream::calculateBufferSize(
-        BUFFER_SIZE_IN_SAMPLES, WORD_SIZE, MAX_READERS);
-    auto tmpBuffer = std::make_shared<alexaClientSDK::avsCommon::avs::AudioInputStream::Buffer>(bufferSize);
-    std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> sharedDataStream =
-        alexaClientSDK::avsCommon::avs::AudioInputStream::create(tmpBuffer, WORD_SIZE, MAX_READERS);
+    std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> sharedDataStream = m_streamBuffer.Create(m_streamSettings, SAMPLE_RATE_HZ);
     if (!sharedDataStream) {
         TRACE(AVSClient, (_T("Failed to create shared data stream!")));
         return false;
@@ -530,7 +586,7 @@ namespace Plugin {
 
     alexaClientSDK::avsCommon::utils::AudioFormat appAudioFromat;
     appAudioFromat.sampleRateHz = SAMPLE_RATE_HZ;
-    appAudioFromat.sampleSizeInBits = WORD_SIZE * CHAR_BIT;
+    appAudioFromat.sampleSizeInBits = m_streamSettings.wordSize * CHAR_BIT;
     appAudioFromat.numChannels = NUM_CHANNELS;
     appAudioFromat.endianness = alexaClientSDK::avsCommon::utils::AudioFormat::Endianness::LITTLE;
     appAudioFromat.encoding = alexaClientSDK::avsCommon::utils::AudioFormat::Encoding::LPCM;
@@ -573,7 +629,7 @@ namespace Plugin {
                 TRACE(AVSClient, (_T("Failed to create aspInputInteractionHandler")));
                 return false;
             }
-            m_thunderVoiceHandler = ThunderVoiceHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>::create(sharedDataStream, _service, audiosource, aspInputInteractionHandler, appAudioFromat);
+            m_thunderVoiceHandler = ThunderVoiceHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>::create(sharedDataStream, _service, audiosource, aspInputInteractionHandler, appAudioFromat, m_voiceSettings);
             aspInput = m_thunderVoiceHandler;
             aspInput->startStreamingMicrophoneData();
         }
@@ -586,7 +642,6 @@ namespace Plugin {
       appWakeAudioProv(capabilityAgents::aip::AudioProvider::null());
       
 // Creating wake word audio provider, if necessary
-#if defined(KWD_PRYON)
     if (enableKWD) {
     appWakeAudioProv = alexaClientSDK::capabilityAgents::aip::AudioProvider(
         sharedDataStream,
@@ -595,20 +650,8 @@ namespace Plugin {
         true,
         false,
         true);
-    
-    
-        m_guiManager = alexaSmartScreenSDK::sampleApp::gui::GUIManager::create(
-        m_guiClient,
-#ifdef ENABLE_PCC
-        phoneCaller,
-#endif
-        appHoldAudioProv,
-        appTapAudioProv,
-        aspInput,
-        appWakeAudioProv);
-}
-#else
-   
+    }
+
     m_guiManager = alexaSmartScreenSDK::sampleApp::gui::GUIManager::create(
         m_guiClient,
 #ifdef ENABLE_PCC
@@ -617,10 +660,7 @@ namespace Plugin {
         appHoldAudioProv,
         appTapAudioProv,
         aspInput,
-        alexaClientSDK::capabilityAgents::aip::AudioProvider::null());
-        
-
-#endif
+        appWakeAudioProv);
     if (audiosource != PORTAUDIO_CALLSIGN) {
             if (aspInputInteractionHandler) {
                 // register interactions that ThunderVoiceHandler may initiate
@@ -692,22 +732,29 @@ namespace Plugin {
         return false;
     }
     
-#if defined(KWD_PRYON)
     if (enableKWD) {    
     auto kwObserver = std::make_shared<alexaSmartScreenSDK::sampleApp::KeywordObserver>(client, appWakeAudioProv);
-    m_keywordDetector = PryonKeywordDetector::create(
+    m_keywordDetector = KeywordDetector::Create(
+        m_keywordEngine,
         sharedDataStream,
         appAudioFromat,
         {kwObserver},
         std::unordered_set<
             std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::KeyWordDetectorStateObserverInterface>>(),
-        pathToInputFolder);
+        pathToInputFolder,
+        m_keywordScheduling);
     if (!m_keywordDetector) {
         TRACE(AVSClient, (_T("Failed to create keyword detector!")));
+    } else {
+        m_keywordDetector->VoiceActivity([this](const bool active) { NotifyVoiceActivity(active); });
+        m_keywordDetector->Detection([this](const std::string& keyword, const uint32_t confidence) { NotifyKeywordDetected(keyword, confidence); });
+        if (m_keywordDetector->SetThresholds(m_keywordThresholds) == false) {
+            TRACE(AVSClient, (_T("Ignoring invalid kwdthresholds, keeping the default detection thresholds")));
+        }
+        m_keywordDetector->Cascade(m_keywordCascade);
     }
         
     }
-#endif
 
     client->addSpeakerManagerObserver(appUI);
     client->addNotificationsObserver(appUI);
@@ -720,6 +767,27 @@ namespace Plugin {
     client->addFocusManagersObserver(m_guiManager);
     client->addAudioInputProcessorObserver(m_guiManager);
     m_guiManager->setClient(client);
+
+    if (aspInputInteractionHandler) {
+        // start recognition where the utterance, including its pre-roll, begins in the stream
+        std::weak_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> weakClient = client;
+        aspInputInteractionHandler->SpliceHoldToTalk(
+            [weakClient, appHoldAudioProv](const avsCommon::avs::AudioInputStream::Index begin) -> std::future<bool> {
+                auto client = weakClient.lock();
+                if (client) {
+                    return (client->notifyOfHoldToTalkStart(appHoldAudioProv, std::chrono::steady_clock::now(), begin));
+                }
+                std::promise<bool> refused;
+                refused.set_value(false);
+                return (refused.get_future());
+            },
+            [weakClient]() {
+                auto client = weakClient.lock();
+                if (client) {
+                    client->notifyOfHoldToTalkEnd();
+                }
+            });
+    }
     m_guiClient->setGUIManager(m_guiManager);
     
     m_shutdownManager = client->getShutdownManager();
@@ -729,7 +797,11 @@ namespace Plugin {
     }
 
     // Thunder Input Manager
-    m_thunderInputManager = ThunderInputManager::create(m_guiManager);
+    std::shared_ptr<HttpDispatcher> dispatcher;
+    if (m_dispatcherSettings.endpoint.empty() == false) {
+        dispatcher = std::make_shared<HttpDispatcher>(m_dispatcherSettings);
+    }
+    m_thunderInputManager = ThunderInputManager::create(m_guiManager, dispatcher);
     if (!m_thunderInputManager) {
         TRACE(AVSClient, (_T("Failed to create m_thunderInputManager")));
       return false;
@@ -759,28 +831,37 @@ namespace Plugin {
     }
 
       
-    bool SmartScreen::InitSDKLogs(const string& logLevel)
+    bool SmartScreen::InitSDKLogs(const string& logLevel, const string& logLevels, const string& recorderLevel, const uint32_t recorderSize)
     {
-//#if 1
         bool status = true;
         std::shared_ptr<avsCommon::utils::logger::Logger> thunderLogger = avsCommon::utils::logger::getThunderLogger();
-        avsCommon::utils::logger::Level logLevelValue = avsCommon::utils::logger::Level::UNKNOWN;
-        string logLevelUpper(logLevel);
-
-        std::transform(logLevelUpper.begin(), logLevelUpper.end(), logLevelUpper.begin(), [](unsigned char c) { return std::toupper(c); });
-        if (logLevelUpper.empty() == false) {
-            logLevelValue = avsCommon::utils::logger::convertNameToLevel(logLevelUpper);
-            if (avsCommon::utils::logger::Level::UNKNOWN == logLevelValue) {
-                TRACE(AVSClient, (_T("Unknown log level")));
+        const avsCommon::utils::logger::Level logLevelValue = ThunderLogger::ToLevel(logLevel);
+        avsCommon::utils::logger::Level recorderLevelValue = avsCommon::utils::logger::Level::NONE;
+        ThunderLogger::ComponentLevelMap componentLevels;
+
+        // Nothing is applied unless all levels are valid
+        if (avsCommon::utils::logger::Level::UNKNOWN == logLevelValue) {
+            TRACE(AVSClient, (_T("Unknown log level")));
+            status = false;
+        }
+        if ((status == true) && (recorderSize > 0)) {
+            recorderLevelValue = ThunderLogger::ToLevel(recorderLevel);
+            if (avsCommon::utils::logger::Level::UNKNOWN == recorderLevelValue) {
+                TRACE(AVSClient, (_T("Unknown flight recorder level")));
                 status = false;
             }
-        } else {
-            status = false;
+        }
+        if (status == true) {
+            status = ThunderLogger::ParseComponentLevels(logLevels, componentLevels);
         }
 
         if (status == true) {
             TRACE(AVSClient, ((_T("Running app with log level: %s"), avsCommon::utils::logger::convertLevelToName(logLevelValue).c_str())));
-            thunderLogger->setLevel(logLevelValue);
+            // The SDK logs down to the most verbose of the trace, component and recorder levels
+            ThunderLogger::Recorder(_service->PersistentPath() + FLIGHT_RECORDER_FILE, recorderSize * 1024);
+            ThunderLogger::RecorderLevel(recorderLevelValue);
+            ThunderLogger::TraceLevel(logLevelValue);
+            ThunderLogger::ComponentLevels(componentLevels);
             avsCommon::utils::logger::LoggerSinkManager::instance().initialize(thunderLogger);
         }
 #if 0
@@ -790,7 +871,7 @@ namespace Plugin {
 
         return status;
     #endif
-    return true;
+    return status;
     }
 
     bool SmartScreen::JsonConfigToStream(std::vector<std::shared_ptr<std::istream>>& streams, const std::string& configFile)
@@ -814,6 +895,10 @@ namespace Plugin {
     {
         TRACE_L1(_T("Deinitialize()"));
 
+        // Keeps what led up to the deactivation
+        string path;
+        ThunderLogger::Dump(path);
+
         return true;
     }
 
@@ -829,6 +914,213 @@ namespace Plugin {
             m_thunderVoiceHandler->stateChange(audiosource);
         }
     }
+
+    uint32_t SmartScreen::VoiceStatistics(string& statistics) const
+    {
+        if (m_thunderVoiceHandler) {
+            return m_thunderVoiceHandler->Statistics(statistics);
+        } else {
+            return WPEFramework::Core::ERROR_UNAVAILABLE;
+        }
+    }
+
+    uint32_t SmartScreen::MemoryStatistics(string& statistics) const
+    {
+        Diagnostics::MemoryStatistics response;
+
+        m_streamBuffer.Report(response);
+        if (m_thunderVoiceHandler) {
+            m_thunderVoiceHandler->Memory(response);
+        }
+
+        if (m_keywordDetector) {
+            m_keywordDetector->Memory(response);
+        }
+
+        response.ToString(statistics);
+        return WPEFramework::Core::ERROR_NONE;
+    }
+
+    uint32_t SmartScreen::KeywordStatistics(string& statistics) const
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            Diagnostics::KeywordStatistics response;
+            m_keywordDetector->Statistics(response);
+            response.ToString(statistics);
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::LogStatistics(string& statistics) const
+    {
+        Diagnostics::LogStatistics response;
+
+        ThunderLogger::Statistics(response);
+
+        response.ToString(statistics);
+        return WPEFramework::Core::ERROR_NONE;
+    }
+
+    uint32_t SmartScreen::DumpLog(string& path)
+    {
+        return ThunderLogger::Dump(path);
+    }
+
+    uint32_t SmartScreen::ObserverStatistics(string& statistics) const
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_thunderInputManager) {
+            Diagnostics::ObserverStatistics response;
+            m_thunderInputManager->Statistics(response);
+            response.ToString(statistics);
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::LogLevel(const string& component, string& level) const
+    {
+        // Without a component, or for one without a level of its own, this is the general trace level
+        level = avsCommon::utils::logger::convertLevelToName(ThunderLogger::ComponentLevel(component));
+        return WPEFramework::Core::ERROR_NONE;
+    }
+
+    uint32_t SmartScreen::SetLogLevel(const string& component, const string& level)
+    {
+        uint32_t result = WPEFramework::Core::ERROR_BAD_REQUEST;
+        const avsCommon::utils::logger::Level value = ThunderLogger::ToLevel(level);
+
+        if (component.empty() == true) {
+            // Without a component the general trace level is addressed
+            if (value != avsCommon::utils::logger::Level::UNKNOWN) {
+                ThunderLogger::TraceLevel(value);
+                result = WPEFramework::Core::ERROR_NONE;
+            }
+        } else if ((level.empty() == true) || (value != avsCommon::utils::logger::Level::UNKNOWN)) {
+            // An empty level drops the component's own level
+            ThunderLogger::ComponentLevel(component, value);
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return result;
+    }
+
+    void SmartScreen::Register(IAVSKeywordDetection::INotification* sink)
+    {
+        ASSERT(sink != nullptr);
+
+        m_keywordNotifications.Register(sink);
+    }
+
+    void SmartScreen::Unregister(const IAVSKeywordDetection::INotification* sink)
+    {
+        ASSERT(sink != nullptr);
+
+        // Does not wait for a fan-out, a sink may unregister from its own callback
+        m_keywordNotifications.Unregister(sink);
+    }
+
+    // Called on the detection thread, the sinks may be remote and a slow one must not hold up detection
+    void SmartScreen::NotifyVoiceActivity(const bool active)
+    {
+        if (m_keywordNotifications.IsEmpty() == false) {
+            SmartScreen* device = this;
+            // Never dropped, the sinks see every edge
+            m_keywordQueue.SubmitState(VOICE_ACTIVITY, (active ? 1 : 0), [device, active]() {
+                device->m_keywordNotifications.ForEach([active](IAVSKeywordDetection::INotification* notification) {
+                    notification->VoiceActivity(active);
+                });
+            });
+        }
+    }
+
+    void SmartScreen::NotifyKeywordDetected(const std::string& keyword, const uint32_t confidence)
+    {
+        if (m_keywordNotifications.IsEmpty() == false) {
+            SmartScreen* device = this;
+            m_keywordQueue.Submit(KEYWORD_DETECTED, [device, keyword, confidence]() {
+                device->m_keywordNotifications.ForEach([&keyword, confidence](IAVSKeywordDetection::INotification* notification) {
+                    notification->KeywordDetected(keyword, confidence);
+                });
+            });
+        }
+    }
+
+    uint32_t SmartScreen::Locale(string& locale) const
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            locale = m_keywordDetector->Locale();
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::SetLocale(const string& locale)
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            result = (m_keywordDetector->SetLocale(locale) == true) ? WPEFramework::Core::ERROR_NONE : WPEFramework::Core::ERROR_UNKNOWN_KEY;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::Keyword(string& keyword) const
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            keyword = m_keywordDetector->Keyword();
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::SetKeyword(const string& keyword)
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            result = (m_keywordDetector->SetKeyword(keyword) == true) ? WPEFramework::Core::ERROR_NONE : WPEFramework::Core::ERROR_UNKNOWN_KEY;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::Threshold(const string& keyword, uint32_t& threshold) const
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            threshold = (keyword.empty() == true) ? m_keywordDetector->Threshold() : m_keywordDetector->Threshold(keyword);
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return result;
+    }
+
+    uint32_t SmartScreen::SetThreshold(const string& keyword, const uint32_t threshold)
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+
+        if (m_keywordDetector) {
+            const bool applied = (keyword.empty() == true) ? m_keywordDetector->SetThreshold(threshold) : m_keywordDetector->SetThreshold(keyword, threshold);
+            result = (applied == true) ? WPEFramework::Core::ERROR_NONE : WPEFramework::Core::ERROR_INVALID_RANGE;
+        }
+
+        return result;
+    }
 }
 }
 
@@ -19,7 +19,15 @@
 
 #pragma once
 #include "ThunderInputManager.h"
+#include "AudioStreamBuffer.h"
+#include "CopyOnWriteRegistry.h"
+#include "IAVSDiagnostics.h"
+#include "IAVSKeywordDetection.h"
+#include "HttpDispatcher.h"
+#include "ThreadScheduling.h"
 #include "ThunderVoiceHandler.h"
+#include "KeywordDetector.h"
+#include "ObserverQueue.h"
 
 #include <WPEFramework/interfaces/IAVSClient.h>
 
@@ -27,6 +35,9 @@
 
 #include <SmartScreen/SampleApp/SampleApplication.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <VoiceToApps/VoiceToApps.h>
@@ -37,6 +48,8 @@ namespace Plugin {
 
     class SmartScreen
         : public WPEFramework::Exchange::IAVSClient,
+          public IAVSDiagnostics,
+          public IAVSKeywordDetection,
           public Core::Thread,
           private alexaSmartScreenSDK::sampleApp::SampleApplication {
     public:
@@ -44,6 +57,16 @@ namespace Plugin {
             : _service(nullptr)
             , m_thunderInputManager(nullptr)
             , m_thunderVoiceHandler(nullptr)
+            , m_voiceSettings()
+            , m_streamSettings()
+            , m_streamBuffer()
+            , m_keywordEngine(KeywordDetector::DEFAULT_ENGINE)
+            , m_keywordThresholds()
+            , m_keywordScheduling()
+            , m_keywordCascade(false)
+            , m_dispatcherSettings()
+            , m_keywordNotifications()
+            , m_keywordQueue(KEYWORD_CALLBACKS, KEYWORD_QUEUE_SIZE)
         {
            Run();
         }
@@ -54,6 +77,9 @@ namespace Plugin {
         {
             Stop();
             Wait(Thread::STOPPED | Thread::BLOCKED, Core::infinite);
+
+            // Stops the detection thread before the queue it submits to goes away
+            m_keywordDetector.reset();
         }
         void CreateSQSWorker(void)
         {
@@ -83,15 +109,51 @@ namespace Plugin {
                 , AlexaClientConfig()
                 , SmartScreenConfig()
                 , LogLevel()
+                , LogLevels()
+                , RecorderLevel(_T("DEBUG0"))
+                , RecorderSize(256)
                 , KWDModelsPath()
+                , KWDEngine()
+                , KWDThresholds()
+                , KWDThread()
+                , KWDCascade()
                 , EnableKWD()
+                , VoiceConcealment()
+                , VoiceDecoder()
+                , VoicePreRoll()
+                , VoiceChannel()
+                , VoiceThread()
+                , VTADispatcher()
+                , StreamReaders()
+                , StreamDuration()
+                , StreamWordSize()
+                , StreamLock()
+                , StreamHugePages()
             {
                 Add(_T("audiosource"), &Audiosource);
                 Add(_T("alexaclientconfig"), &AlexaClientConfig);
                 Add(_T("smartscreenconfig"), &SmartScreenConfig);
                 Add(_T("loglevel"), &LogLevel);
+                Add(_T("loglevels"), &LogLevels);
+                Add(_T("recorderlevel"), &RecorderLevel);
+                Add(_T("recordersize"), &RecorderSize);
                 Add(_T("kwdmodelspath"), &KWDModelsPath);
+                Add(_T("kwdengine"), &KWDEngine);
+                Add(_T("kwdthresholds"), &KWDThresholds);
+                Add(_T("kwdthread"), &KWDThread);
+                Add(_T("kwdcascade"), &KWDCascade);
                 Add(_T("enablekwd"), &EnableKWD);
+                Add(_T("voiceconcealment"), &VoiceConcealment);
+                Add(_T("voicedecoder"), &VoiceDecoder);
+                Add(_T("voicepreroll"), &VoicePreRoll);
+                Add(_T("voicechannel"), &VoiceChannel);
+                Add(_T("voicethread"), &VoiceThread);
+                Add(_T("vtadispatcher"), &VTADispatcher);
+                Add(_T("streamreaders"), &StreamReaders);
+                Add(_T("streamduration"), &StreamDuration);
+                Add(_T("streamwordsize"), &StreamWordSize);
+                Add(_T("streamlock"), &StreamLock);
+                Add(_T("streamhugepages"), &StreamHugePages);
             }
 
             ~Config() = default;
@@ -101,8 +163,26 @@ namespace Plugin {
             WPEFramework::Core::JSON::String AlexaClientConfig;
             WPEFramework::Core::JSON::String SmartScreenConfig;
             WPEFramework::Core::JSON::String LogLevel;
+            WPEFramework::Core::JSON::String LogLevels;
+            WPEFramework::Core::JSON::String RecorderLevel;
+            WPEFramework::Core::JSON::DecUInt32 RecorderSize;
             WPEFramework::Core::JSON::String KWDModelsPath;
+            WPEFramework::Core::JSON::String KWDEngine;
+            WPEFramework::Core::JSON::String KWDThresholds;
+            ThreadSchedulingConfig KWDThread;
+            WPEFramework::Core::JSON::Boolean KWDCascade;
             WPEFramework::Core::JSON::Boolean EnableKWD;
+            WPEFramework::Core::JSON::String VoiceConcealment;
+            WPEFramework::Core::JSON::String VoiceDecoder;
+            WPEFramework::Core::JSON::DecUInt16 VoicePreRoll;
+            WPEFramework::Core::JSON::String VoiceChannel;
+            ThreadSchedulingConfig VoiceThread;
+            HttpDispatcherConfig VTADispatcher;
+            WPEFramework::Core::JSON::DecUInt8 StreamReaders;
+            WPEFramework::Core::JSON::DecUInt16 StreamDuration;
+            WPEFramework::Core::JSON::DecUInt8 StreamWordSize;
+            WPEFramework::Core::JSON::Boolean StreamLock;
+            WPEFramework::Core::JSON::Boolean StreamHugePages;
         };
 
     public:
@@ -110,25 +190,66 @@ namespace Plugin {
         bool Deinitialize() override;
         Exchange::IAVSController* Controller() override;
         void StateChange(PluginHost::IShell* audioSource) override;
+
+        // IAVSDiagnostics methods
+        uint32_t VoiceStatistics(string& statistics) const override;
+        uint32_t MemoryStatistics(string& statistics) const override;
+        uint32_t KeywordStatistics(string& statistics) const override;
+        uint32_t LogStatistics(string& statistics) const override;
+        uint32_t DumpLog(string& path) override;
+        uint32_t ObserverStatistics(string& statistics) const override;
+        uint32_t LogLevel(const string& component, string& level) const override;
+        uint32_t SetLogLevel(const string& component, const string& level) override;
+
+        // IAVSKeywordDetection methods
+        void Register(IAVSKeywordDetection::INotification* sink) override;
+        void Unregister(const IAVSKeywordDetection::INotification* sink) override;
+        uint32_t Locale(string& locale) const override;
+        uint32_t SetLocale(const string& locale) override;
+        uint32_t Keyword(string& keyword) const override;
+        uint32_t SetKeyword(const string& keyword) override;
+        uint32_t Threshold(const string& keyword, uint32_t& threshold) const override;
+        uint32_t SetThreshold(const string& keyword, const uint32_t threshold) override;
         skillmapper::voiceToApps vta;
 
         BEGIN_INTERFACE_MAP(SmartScreen)
         INTERFACE_ENTRY(WPEFramework::Exchange::IAVSClient)
+        INTERFACE_ENTRY(IAVSDiagnostics)
+        INTERFACE_ENTRY(IAVSKeywordDetection)
         END_INTERFACE_MAP
 
     private:
+        // The detection callbacks that hand their fan-out to m_keywordQueue
+        enum KeywordCallback : uint8_t {
+            VOICE_ACTIVITY,
+            KEYWORD_DETECTED
+        };
+        static constexpr size_t KEYWORD_QUEUE_SIZE = 16;
+        static const std::vector<std::string> KEYWORD_CALLBACKS;
+
+        void NotifyVoiceActivity(const bool active);
+        void NotifyKeywordDetected(const std::string& keyword, const uint32_t confidence);
         bool Init(const std::string& audiosource, const bool enableKWD, const std::string& pathToInputFolder, const
         std::string alexaClientConfig, const std::string smartScreenConfig);
-        bool InitSDKLogs(const string& logLevel);
+        bool InitSDKLogs(const string& logLevel, const string& logLevels, const string& recorderLevel, const uint32_t recorderSize);
         bool JsonConfigToStream(std::vector<std::shared_ptr<std::istream>>& streams, const std::string& configFile);
 
     private:
         WPEFramework::PluginHost::IShell* _service;
         std::shared_ptr<ThunderInputManager> m_thunderInputManager;
         std::shared_ptr<ThunderVoiceHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>> m_thunderVoiceHandler;
-#if defined(KWD_PRYON)
-        std::unique_ptr<alexaClientSDK::kwd::AbstractKeywordDetector> m_keywordDetector;
-#endif
+        ThunderVoiceHandlerSettings m_voiceSettings;
+        AudioStreamSettings m_streamSettings;
+        AudioStreamBuffer m_streamBuffer;
+        std::string m_keywordEngine;
+        std::string m_keywordThresholds;
+        ThreadScheduling m_keywordScheduling;
+        bool m_keywordCascade;
+        HttpDispatcher::Settings m_dispatcherSettings;
+        std::unique_ptr<KeywordDetector> m_keywordDetector;
+        CopyOnWriteRegistry<IAVSKeywordDetection::INotification> m_keywordNotifications;
+        // Last, so its thread is gone before the sinks are released
+        ObserverQueue m_keywordQueue;
     };
 
 }
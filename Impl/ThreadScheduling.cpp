@@ -0,0 +1,127 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadScheduling.h"
+#include "TraceCategories.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    static constexpr size_t MAX_THREAD_NAME = 15;
+
+    /* static */ bool ThreadScheduling::FromString(const string& policy, Policy& result)
+    {
+        bool status = true;
+        if ((policy.empty() == true) || (policy == _T("other"))) {
+            result = Policy::OTHER;
+        } else if (policy == _T("fifo")) {
+            result = Policy::FIFO;
+        } else if (policy == _T("rr")) {
+            result = Policy::ROUND_ROBIN;
+        } else {
+            status = false;
+        }
+        return status;
+    }
+
+    /* static */ bool ThreadScheduling::ParseCpus(const string& list, std::vector<unsigned int>& cpus)
+    {
+        std::vector<unsigned int> result;
+        std::istringstream items(list);
+        string item;
+        while (std::getline(items, item, ',')) {
+            if (item.empty() == true) {
+                continue;
+            }
+
+            const size_t separator = item.find('-');
+            const string firstCpu = item.substr(0, separator);
+            const string lastCpu = (separator == string::npos) ? firstCpu : item.substr(separator + 1);
+            if ((firstCpu.empty() == true) || (lastCpu.empty() == true)
+                || (firstCpu.find_first_not_of(_T("0123456789")) != string::npos)
+                || (lastCpu.find_first_not_of(_T("0123456789")) != string::npos)
+                || (firstCpu.size() > 4) || (lastCpu.size() > 4)) {
+                return false;
+            }
+
+            const unsigned int first = static_cast<unsigned int>(std::stoul(firstCpu));
+            const unsigned int last = static_cast<unsigned int>(std::stoul(lastCpu));
+            if ((last < first) || (last >= CPU_SETSIZE)) {
+                return false;
+            }
+            for (unsigned int cpu = first; cpu <= last; ++cpu) {
+                result.push_back(cpu);
+            }
+        }
+
+        cpus = std::move(result);
+        return true;
+    }
+
+    bool ThreadScheduling::IsValid() const
+    {
+        bool status = true;
+        if (policy != Policy::OTHER) {
+            const int native = (policy == Policy::FIFO) ? SCHED_FIFO : SCHED_RR;
+            status = ((priority >= ::sched_get_priority_min(native)) && (priority <= ::sched_get_priority_max(native)));
+        }
+        return status;
+    }
+
+    void ThreadScheduling::Apply(const char name[]) const
+    {
+        const pthread_t self = ::pthread_self();
+
+        char shortName[MAX_THREAD_NAME + 1];
+        ::strncpy(shortName, name, MAX_THREAD_NAME);
+        shortName[MAX_THREAD_NAME] = '\0';
+        ::pthread_setname_np(self, shortName);
+
+        if (policy != Policy::OTHER) {
+            struct sched_param parameters;
+            ::memset(&parameters, 0, sizeof(parameters));
+            parameters.sched_priority = priority;
+            const int error = ::pthread_setschedparam(self, (policy == Policy::FIFO) ? SCHED_FIFO : SCHED_RR, &parameters);
+            if (error != 0) {
+                TRACE_GLOBAL(AVSClient, (_T("Failed to schedule %s at real-time priority %d: %s"), shortName, priority, ::strerror(error)));
+            }
+        }
+
+        if (affinity.empty() == false) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (const unsigned int cpu : affinity) {
+                CPU_SET(cpu, &cpus);
+            }
+            const int error = ::pthread_setaffinity_np(self, sizeof(cpus), &cpus);
+            if (error != 0) {
+                TRACE_GLOBAL(AVSClient, (_T("Failed to set the CPU affinity of %s: %s"), shortName, ::strerror(error)));
+            }
+        }
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,106 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /// Scheduling of a thread of the audio input path
+    struct ThreadScheduling {
+        enum class Policy {
+            OTHER,
+            FIFO,
+            ROUND_ROBIN
+        };
+
+        ThreadScheduling()
+            : policy{ Policy::OTHER }
+            , priority{ 0 }
+            , affinity()
+        {
+        }
+
+        Policy policy;
+        // Real-time priority of the FIFO and ROUND_ROBIN policies (1 - 99), ignored for OTHER
+        int priority;
+        // CPUs the thread may run on, empty for any
+        std::vector<unsigned int> affinity;
+
+        // "other", "fifo" or "rr"
+        static bool FromString(const string& policy, Policy& result);
+        // Comma separated CPUs and CPU ranges, e.g. "1,3" or "2-3"
+        static bool ParseCpus(const string& list, std::vector<unsigned int>& cpus);
+
+        bool IsValid() const;
+
+        // Names the calling thread (at most 15 characters are kept) and applies the scheduling to it.
+        // A setting the process may not apply, e.g. a real-time policy without CAP_SYS_NICE, is
+        // traced and left at its default; the thread runs regardless.
+        void Apply(const char name[]) const;
+    };
+
+    class ThreadSchedulingConfig : public Core::JSON::Container {
+    public:
+        ThreadSchedulingConfig(const ThreadSchedulingConfig&) = delete;
+        ThreadSchedulingConfig& operator=(const ThreadSchedulingConfig&) = delete;
+
+    public:
+        ThreadSchedulingConfig()
+            : Core::JSON::Container()
+            , Policy()
+            , Priority()
+            , Affinity()
+        {
+            Add(_T("policy"), &Policy);
+            Add(_T("priority"), &Priority);
+            Add(_T("affinity"), &Affinity);
+        }
+
+        ~ThreadSchedulingConfig() override = default;
+
+        // Fills in the settings, leaving what is not configured at its default
+        bool Get(ThreadScheduling& settings) const
+        {
+            bool status = true;
+            if (Policy.IsSet() == true) {
+                status = ThreadScheduling::FromString(Policy.Value(), settings.policy);
+            }
+            if (Priority.IsSet() == true) {
+                settings.priority = Priority.Value();
+            }
+            if ((status == true) && (Affinity.IsSet() == true)) {
+                status = ThreadScheduling::ParseCpus(Affinity.Value(), settings.affinity);
+            }
+            return ((status == true) && (settings.IsValid() == true));
+        }
+
+    public:
+        Core::JSON::String Policy;
+        Core::JSON::DecUInt8 Priority;
+        Core::JSON::String Affinity;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
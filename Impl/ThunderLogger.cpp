@@ -24,6 +24,11 @@
 #include <WPEFramework/core/Trace.h>
 #include <WPEFramework/tracing/tracing.h>
 
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+
 namespace WPEFramework {
 namespace Plugin {
 
@@ -32,6 +37,13 @@ namespace Plugin {
     using namespace alexaClientSDK::avsCommon::utils::logger;
 
     static const std::string CONFIG_KEY_DEFAULT_LOGGER = "thunderLogger";
+    // The dispatch thread also wakes up by itself, should a producer miss that it went to sleep
+    static const std::chrono::milliseconds DISPATCH_IDLE = std::chrono::milliseconds(50);
+    // A burst of errors is worth one flight recorder dump, the later errors get the next one
+    static const std::chrono::seconds ERROR_DUMP_INTERVAL = std::chrono::seconds(60);
+    static const std::chrono::seconds DUMP_TIMEOUT = std::chrono::seconds(5);
+
+    constexpr size_t ThunderLogger::RING_RECORDS;
 
     std::shared_ptr<Logger> ThunderLogger::instance()
     {
@@ -41,8 +53,157 @@ namespace Plugin {
 
     ThunderLogger::ThunderLogger()
         : Logger(Level::UNKNOWN)
+        , m_ring(RING_RECORDS)
+        , m_lock()
+        , m_signal()
+        , m_isWaiting{ false }
+        , m_filterLock()
+        , m_filter(std::make_shared<const LogFilter>(Level::DEBUG9))
+        , m_recorderSeverity{ static_cast<uint8_t>(Level::NONE) }
+        , m_isRunning{ true }
+        , m_isRecorderChanged{ false }
+        , m_pendingRecorder()
+        , m_pendingPath()
+        , m_dumpRequests{ 0 }
+        , m_dumps{ 0 }
+        , m_dumpResult{ Core::ERROR_UNAVAILABLE }
+        , m_dumped()
+        , m_recorder()
+        , m_recorderPath()
+        , m_thread()
     {
         init(configuration::ConfigurationNode::getRoot()[CONFIG_KEY_DEFAULT_LOGGER]);
+        m_thread = std::thread(&ThunderLogger::Dispatch, this);
+    }
+
+    ThunderLogger::~ThunderLogger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_isRunning = false;
+        }
+        m_signal.notify_one();
+        if (m_thread.joinable() == true) {
+            m_thread.join();
+        }
+    }
+
+    void ThunderLogger::Statistics(Diagnostics::LogStatistics& statistics)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        const LogRing::Statistics counters = logger->m_ring.Counters();
+
+        statistics.Records = counters.pushedRecords;
+        statistics.Dropped = counters.droppedRecords;
+        statistics.Truncated = counters.truncatedRecords;
+        statistics.Capacity = static_cast<uint32_t>(counters.capacity);
+        statistics.HighWaterMark = static_cast<uint32_t>(counters.highWaterMark);
+    }
+
+    Level ThunderLogger::ToLevel(const std::string& name)
+    {
+        std::string upper(name);
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+
+        return ((upper.empty() == false) ? convertNameToLevel(upper) : Level::UNKNOWN);
+    }
+
+    template <typename ACTION>
+    void ThunderLogger::Filter(ACTION&& action)
+    {
+        std::lock_guard<std::mutex> lock(m_filterLock);
+
+        const std::shared_ptr<LogFilter> filter = std::make_shared<LogFilter>(*m_filter);
+        action(*filter);
+        std::atomic_store(&m_filter, std::shared_ptr<const LogFilter>(filter));
+
+        // The SDK does not even build the lines below the Logger level, so it follows the most verbose use of them
+        setLevel(std::min(filter->Lowest(), static_cast<Level>(m_recorderSeverity.load())));
+    }
+
+    void ThunderLogger::TraceLevel(const Level level)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        logger->Filter([level](LogFilter& filter) { filter.Default(level); });
+    }
+
+    void ThunderLogger::RecorderLevel(const Level level)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        logger->Filter([&logger, level](LogFilter&) { logger->m_recorderSeverity = static_cast<uint8_t>(level); });
+    }
+
+    Level ThunderLogger::ComponentLevel(const std::string& component)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        return (std::atomic_load(&logger->m_filter)->Component(component));
+    }
+
+    void ThunderLogger::ComponentLevel(const std::string& component, const Level level)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        logger->Filter([&component, level](LogFilter& filter) { filter.Component(component, level); });
+    }
+
+    /* static */ bool ThunderLogger::ParseComponentLevels(const std::string& levels, ComponentLevelMap& entries)
+    {
+        entries.clear();
+        std::istringstream list(levels);
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+            if (item.empty() == true) {
+                continue;
+            }
+
+            const size_t separator = item.find('=');
+            const Level level = ((separator != 0) && (separator != std::string::npos)) ? ToLevel(item.substr(separator + 1)) : Level::UNKNOWN;
+            if (level == Level::UNKNOWN) {
+                TRACE(AVSClient, (_T("Malformed log level '%s'"), item.c_str()));
+                return false;
+            }
+            entries[item.substr(0, separator)] = level;
+        }
+        return true;
+    }
+
+    /* static */ void ThunderLogger::ComponentLevels(const ComponentLevelMap& entries)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        logger->Filter([&entries](LogFilter& filter) {
+            for (const auto& entry : entries) {
+                filter.Component(entry.first, entry.second);
+            }
+        });
+    }
+
+    void ThunderLogger::Recorder(const std::string& path, const size_t size)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        {
+            std::lock_guard<std::mutex> lock(logger->m_lock);
+            logger->m_pendingRecorder.reset((size > 0) ? new FlightRecorder(size) : nullptr);
+            logger->m_pendingPath = path;
+            logger->m_isRecorderChanged = true;
+        }
+        logger->m_signal.notify_one();
+    }
+
+    uint32_t ThunderLogger::Dump(std::string& path)
+    {
+        const std::shared_ptr<ThunderLogger> logger = std::static_pointer_cast<ThunderLogger>(instance());
+        uint32_t result = Core::ERROR_TIMEDOUT;
+
+        std::unique_lock<std::mutex> lock(logger->m_lock);
+        const uint32_t request = ++logger->m_dumpRequests;
+        logger->m_signal.notify_one();
+        // The logger thread writes what the SDK logged up to here, then the file
+        if (logger->m_dumped.wait_for(lock, DUMP_TIMEOUT, [&logger, request]() { return (static_cast<int32_t>(logger->m_dumps - request) >= 0); }) == true) {
+            result = logger->m_dumpResult;
+            path = logger->m_pendingPath;
+        }
+
+        return (result);
     }
 
     void ThunderLogger::Trace(const std::string& stringToPrint)
@@ -81,9 +242,103 @@ namespace Plugin {
         const char* text)
     {
 
-        std::stringstream ss;
-        ss << "[" << threadMoniker << "] " << convertLevelToChar(level) << " " << text;
-        TRACE(AVSSDK, (ss.str().c_str()));
+        // The SDK already checked the Logger level, only a component or the recorder may still want the line
+        const bool isTraced = (level >= std::atomic_load(&m_filter)->Threshold(text));
+        if ((isTraced == false) && (static_cast<uint8_t>(level) < m_recorderSeverity.load(std::memory_order_relaxed))) {
+            return;
+        }
+
+        const uint64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+
+        if ((m_ring.Push(microseconds, static_cast<uint8_t>(level), convertLevelToChar(level), threadMoniker, text, isTraced) == true)
+            && (m_isWaiting.load() == true)) {
+            m_signal.notify_one();
+        }
+    }
+
+    void ThunderLogger::Dispatch()
+    {
+        LogRing::Record record;
+        uint64_t reported = 0;
+        bool isErrorLogged = false;
+        bool hasErrorDump = false;
+        std::chrono::steady_clock::time_point errorDump;
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (true) {
+            if (m_isRecorderChanged == true) {
+                m_recorder = std::move(m_pendingRecorder);
+                m_recorderPath = m_pendingPath;
+                m_isRecorderChanged = false;
+            }
+            const uint32_t requests = m_dumpRequests;
+            lock.unlock();
+
+            while (m_ring.Pop(record) == true) {
+                if (m_recorder) {
+                    m_recorder->Record(record.time, record.level, record.moniker, record.text, record.length, record.isTruncated);
+                }
+                if (record.isTraced == true) {
+                    Forward(record);
+                }
+                if (record.severity >= static_cast<uint8_t>(Level::ERROR)) {
+                    isErrorLogged = true;
+                }
+            }
+            const uint64_t dropped = m_ring.Counters().droppedRecords;
+            if (dropped != reported) {
+                TRACE(AVSSDK, (_T("%llu SDK log lines dropped, the log sink fell behind"), static_cast<unsigned long long>(dropped - reported)));
+                reported = dropped;
+            }
+
+            uint32_t result = Core::ERROR_UNAVAILABLE;
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            const bool isErrorDue = (isErrorLogged == true) && ((hasErrorDump == false) || ((now - errorDump) >= ERROR_DUMP_INTERVAL));
+            if ((requests != m_dumps) || ((isErrorDue == true) && (m_recorder))) {
+                result = Save();
+            }
+            if (isErrorDue == true) {
+                isErrorLogged = false;
+                hasErrorDump = true;
+                errorDump = now;
+            }
+            lock.lock();
+
+            if (requests != m_dumps) {
+                m_dumpResult = result;
+                m_dumps = requests;
+                m_dumped.notify_all();
+            }
+            if ((m_isRunning == false) && (m_ring.IsEmpty() == true)) {
+                break;
+            }
+            m_isWaiting = true;
+            m_signal.wait_for(lock, DISPATCH_IDLE, [this]() { return ((m_ring.IsEmpty() == false) || (m_isRunning == false) || (m_isRecorderChanged == true) || (m_dumpRequests != m_dumps)); });
+            m_isWaiting = false;
+        }
+    }
+
+    uint32_t ThunderLogger::Save() const
+    {
+        uint32_t result = Core::ERROR_UNAVAILABLE;
+
+        if (m_recorder) {
+            const uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            if (m_recorder->Dump(m_recorderPath, now) == true) {
+                TRACE(AVSClient, (_T("Flight recorder written to %s"), m_recorderPath.c_str()));
+                result = Core::ERROR_NONE;
+            } else {
+                TRACE(AVSClient, (_T("Failed to write the flight recorder to %s"), m_recorderPath.c_str()));
+                result = Core::ERROR_WRITE_ERROR;
+            }
+        }
+
+        return (result);
+    }
+
+    void ThunderLogger::Forward(const LogRing::Record& record) const
+    {
+        TRACE(AVSSDK, (_T("[%s] %c %s%s"), record.moniker, record.level, record.text, (record.isTruncated == true) ? "..." : ""));
     }
 
 } // namespace Plugin
@@ -19,23 +19,64 @@
 
 #pragma once
 
+#include "FlightRecorder.h"
+#include "IAVSDiagnostics.h"
+#include "LogFilter.h"
+#include "LogRing.h"
+
 #include <AVS/AVSCommon/Utils/Logger/Logger.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 
 namespace WPEFramework {
 namespace Plugin {
 
     /**
      * Handles AVS SDK logs through Thunder Tracing
+     *
+     * emit() runs on the SDK thread that logged, so it only copies the line into a LogRing.
+     * A thread of the logger formats the lines and hands them to Thunder tracing.
+     *
+     * The same thread keeps all lines, also those below the trace level, in a FlightRecorder.
+     * The recorder is written to a file on request and shortly after the SDK logged an error.
+     *
+     * The trace level can be set per SDK component through a LogFilter. emit() drops the lines
+     * that are neither traced nor recorded, and the Logger level, which the SDK checks before it
+     * builds the text of a line, follows the most verbose of the component and recorder levels.
     */
     class ThunderLogger : public alexaClientSDK::avsCommon::utils::logger::Logger {
     public:
+        typedef std::map<std::string, alexaClientSDK::avsCommon::utils::logger::Level> ComponentLevelMap;
+
         ThunderLogger(const ThunderLogger&) = delete;
         ThunderLogger& operator=(const ThunderLogger&) = delete;
 
+        ~ThunderLogger() override;
+
         static std::shared_ptr<alexaClientSDK::avsCommon::utils::logger::Logger> instance();
+        static void Statistics(Diagnostics::LogStatistics& statistics);
+        // Level of a capitalized level name, UNKNOWN when there is no such level
+        static alexaClientSDK::avsCommon::utils::logger::Level ToLevel(const std::string& name);
+        // Lines below the level are not traced, only recorded, unless their component has a level of its own
+        static void TraceLevel(const alexaClientSDK::avsCommon::utils::logger::Level level);
+        // Lines below the level are not recorded, NONE records nothing
+        static void RecorderLevel(const alexaClientSDK::avsCommon::utils::logger::Level level);
+        // Trace level of an SDK component, the general one when it has none of its own
+        static alexaClientSDK::avsCommon::utils::logger::Level ComponentLevel(const std::string& component);
+        // UNKNOWN gives the component the general trace level again
+        static void ComponentLevel(const std::string& component, const alexaClientSDK::avsCommon::utils::logger::Level level);
+        // Comma separated component levels, e.g. "ACL=WARN,AIP=DEBUG0", false when one is malformed
+        static bool ParseComponentLevels(const std::string& levels, ComponentLevelMap& entries);
+        static void ComponentLevels(const ComponentLevelMap& entries);
+        // Replaces the flight recorder, no recorder when the size is 0
+        static void Recorder(const std::string& path, const size_t size);
+        // Writes the flight recorder to its file and returns the path of it
+        static uint32_t Dump(std::string& path);
 
         static void Trace(const std::string& stringToPrint);
         static void PrettyTrace(const std::string& stringToPrint);
@@ -47,6 +88,41 @@ namespace Plugin {
 
     private:
         ThunderLogger();
+
+        template <typename ACTION>
+        void Filter(ACTION&& action);
+        void Dispatch();
+        void Forward(const LogRing::Record& record) const;
+        uint32_t Save() const;
+
+    private:
+        static constexpr size_t RING_RECORDS = 512;
+
+        LogRing m_ring;
+        std::mutex m_lock;
+        std::condition_variable m_signal;
+        std::atomic<bool> m_isWaiting;
+
+        // Replaced as a whole under m_filterLock, read without a lock by emit()
+        std::mutex m_filterLock;
+        std::shared_ptr<const LogFilter> m_filter;
+        std::atomic<uint8_t> m_recorderSeverity;
+        bool m_isRunning;
+
+        // Handed over to the logger thread under m_lock
+        bool m_isRecorderChanged;
+        std::unique_ptr<FlightRecorder> m_pendingRecorder;
+        std::string m_pendingPath;
+        uint32_t m_dumpRequests;
+        uint32_t m_dumps;
+        uint32_t m_dumpResult;
+        std::condition_variable m_dumped;
+
+        // Owned by the logger thread
+        std::unique_ptr<FlightRecorder> m_recorder;
+        std::string m_recorderPath;
+
+        std::thread m_thread;
     };
 
 } // namespace Plugin
@@ -20,7 +20,14 @@
 #pragma once
 
 #include "Module.h"
+#include "AudioConverter.h"
+#include "AudioStagingRing.h"
 #include "CompatibleAudioFormat.h"
+#include "IAVSDiagnostics.h"
+#include "PacketLossConcealment.h"
+#include "SharedAudioChannel.h"
+#include "ThreadScheduling.h"
+#include "VoiceDecoder.h"
 #include "TraceCategories.h"
 
 #include <WPEFramework/interfaces/IVoiceHandler.h>
@@ -33,8 +40,16 @@
 #include <SmartScreen/SampleApp/GUI/GUIManager.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <limits>
 #include <mutex>
 #include <thread>
+#include <time.h>
+#include <vector>
 
 namespace WPEFramework {
 namespace Plugin {
@@ -43,6 +58,11 @@ namespace Plugin {
     template <typename MANAGER>
     class InteractionHandler {
     public:
+        using Index = alexaClientSDK::avsCommon::avs::AudioInputStream::Index;
+        // Returns without waiting for the SDK, the future tells whether recognition started
+        using HoldStart = std::function<std::future<bool>(const Index begin)>;
+        using HoldEnd = std::function<void()>;
+
         static std::unique_ptr<InteractionHandler> Create()
         {
             std::unique_ptr<InteractionHandler<MANAGER>> interactionHandler(new InteractionHandler<MANAGER>());
@@ -61,6 +81,10 @@ namespace Plugin {
     private:
         InteractionHandler()
             : m_interactionManager{ nullptr }
+            , m_holdStart{ nullptr }
+            , m_holdEnd{ nullptr }
+            , m_holdStarted{}
+            , m_isHoldOccurring{ false }
         {
         }
 
@@ -82,13 +106,63 @@ namespace Plugin {
                 m_interactionManager.reset();
                 status = true;
             }
+            m_holdStart = nullptr;
+            m_holdEnd = nullptr;
+            m_holdStarted = std::shared_future<bool>();
+            m_isHoldOccurring = false;
             return status;
         }
 
-        void HoldToTalk();
+        /// Lets hold-to-talk start reading the stream at a given index instead of after the writer.
+        void SpliceHoldToTalk(HoldStart start, HoldEnd end)
+        {
+            m_holdStart = start;
+            m_holdEnd = end;
+        }
+
+        /// Starts a hold-to-talk interaction, recognition begins at the begin index when splicing is set up.
+        /// Does nothing while an interaction is held already.
+        void Begin(const Index begin)
+        {
+            if (m_isHoldOccurring == false) {
+                if (m_holdStart && m_holdEnd) {
+                    // Called on the drain thread, so the start completes on the SDK's executor instead
+                    m_holdStarted = m_holdStart(begin).share();
+                    m_isHoldOccurring = m_holdStarted.valid();
+                } else {
+                    HoldToTalk();
+                    m_isHoldOccurring = true;
+                }
+            }
+        }
+
+        /// Ends the interaction started by Begin(), does nothing when none is held.
+        void End()
+        {
+            if (m_isHoldOccurring == true) {
+                if (m_holdStarted.valid() == true) {
+                    // The SDK runs the end after the start, it is only left out when the start is known to have failed
+                    const bool isRefused = (m_holdStarted.wait_for(std::chrono::seconds(0)) == std::future_status::ready) && (m_holdStarted.get() == false);
+                    if ((isRefused == false) && (m_holdEnd)) {
+                        m_holdEnd();
+                    }
+                    m_holdStarted = std::shared_future<bool>();
+                } else {
+                    HoldToTalk();
+                }
+                m_isHoldOccurring = false;
+            }
+        }
 
     private:
+        // Toggles hold-to-talk in the SDK, only called on a change of m_isHoldOccurring
+        void HoldToTalk();
+
         std::shared_ptr<MANAGER> m_interactionManager;
+        HoldStart m_holdStart;
+        HoldEnd m_holdEnd;
+        std::shared_future<bool> m_holdStarted;
+        bool m_isHoldOccurring;
     };
 
     template <>
@@ -109,11 +183,33 @@ namespace Plugin {
     }
 #endif
 
+    /// Tunables of the Thunder voice input path
+    struct ThunderVoiceHandlerSettings {
+        ThunderVoiceHandlerSettings()
+            : concealment{ PacketLossConcealer::Strategy::ZERO }
+            , decoder{ "ima-adpcm" }
+            , preRoll{ 0 }
+            , channel()
+            , scheduling()
+        {
+        }
+
+        PacketLossConcealer::Strategy concealment;
+        // VoiceDecoder used for profiles that are not tagged as PCM
+        std::string decoder;
+        // Audio preceding the start of an utterance that is handed to hold-to-talk recognition
+        std::chrono::milliseconds preRoll;
+        // Path of the SharedAudioChannel offered to the producer, empty for COM-RPC delivery only
+        string channel;
+        // Scheduling of the thread that drains the staged packets into the stream
+        ThreadScheduling scheduling;
+    };
+
     // This class provides the audio input from Thunder
     template <typename MANAGER>
     class ThunderVoiceHandler : public alexaClientSDK::applicationUtilities::resources::audio::MicrophoneInterface {
     public:
-        static std::unique_ptr<ThunderVoiceHandler> create(std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream, WPEFramework::PluginHost::IShell* service, const string& callsign, std::shared_ptr<InteractionHandler<MANAGER>> interactionHandler, alexaClientSDK::avsCommon::utils::AudioFormat audioFormat)
+        static std::unique_ptr<ThunderVoiceHandler> create(std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream, WPEFramework::PluginHost::IShell* service, const string& callsign, std::shared_ptr<InteractionHandler<MANAGER>> interactionHandler, alexaClientSDK::avsCommon::utils::AudioFormat audioFormat, const ThunderVoiceHandlerSettings& settings = ThunderVoiceHandlerSettings())
         {
             if (!stream) {
                 TRACE_GLOBAL(AVSClient, (_T("Invalid stream")));
@@ -130,7 +226,7 @@ namespace Plugin {
                 return nullptr;
             }
 
-            std::unique_ptr<ThunderVoiceHandler> thunderVoiceHandler(new ThunderVoiceHandler(stream, service, callsign, interactionHandler));
+            std::unique_ptr<ThunderVoiceHandler> thunderVoiceHandler(new ThunderVoiceHandler(stream, service, callsign, interactionHandler, settings));
             if (!thunderVoiceHandler) {
                 TRACE_GLOBAL(AVSClient, (_T("Failed to create a ThunderVoiceHandler!")));
                 return nullptr;
@@ -182,13 +278,50 @@ namespace Plugin {
 
         ~ThunderVoiceHandler()
         {
+            StopDraining();
+
             if (m_service != nullptr) {
                 m_service->Release();
             }
         }
 
     private:
-        ThunderVoiceHandler(std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream, WPEFramework::PluginHost::IShell* service, const string& callsign, std::shared_ptr<InteractionHandler<MANAGER>> interactionHandler)
+        /// Input format announced by the IVoiceProducer profile, staged with the start marker
+        struct StreamFormat {
+            StreamFormat()
+                : codec{ WPEFramework::Exchange::IVoiceProducer::IProfile::PCM }
+                , sampleRate{ AudioFormatCompatibility::SAMPLE_RATE_HZ }
+                , channels{ AudioFormatCompatibility::NUM_CHANNELS }
+                , resolution{ AudioFormatCompatibility::SAMPLE_SIZE_IN_BITS }
+            {
+            }
+
+            bool IsCompressed() const
+            {
+                return ((codec != WPEFramework::Exchange::IVoiceProducer::IProfile::UNDEFINED) && (codec != WPEFramework::Exchange::IVoiceProducer::IProfile::PCM));
+            }
+
+            uint8_t codec;
+            uint32_t sampleRate;
+            uint8_t channels;
+            uint8_t resolution;
+        };
+
+        /// Utterance boundary, ordered against the audio by the staging ring position it was posted at
+        struct Marker {
+            Marker()
+                : position{ 0 }
+                , flags{ 0 }
+                , format()
+            {
+            }
+
+            size_t position;
+            uint16_t flags;
+            StreamFormat format;
+        };
+
+        ThunderVoiceHandler(std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> stream, WPEFramework::PluginHost::IShell* service, const string& callsign, std::shared_ptr<InteractionHandler<MANAGER>> interactionHandler, const ThunderVoiceHandlerSettings& settings)
             : m_audioInputStream{ stream }
             , m_callsign{ callsign }
             , m_service{ service }
@@ -196,6 +329,38 @@ namespace Plugin {
             , m_isInitialized{ false }
             , m_interactionHandler{ interactionHandler }
             , m_voiceHandler{ WPEFramework::Core::ProxyType<VoiceHandler>::Create(this) }
+            , m_ring{ STAGING_RING_SIZE }
+            , m_markers()
+            , m_markerHead{ 0 }
+            , m_markerTail{ 0 }
+            , m_isDraining{ false }
+            , m_scheduling(settings.scheduling)
+            , m_concealer{ settings.concealment }
+            , m_concealment{ settings.concealment }
+            , m_statisticsLock()
+            , m_lastUtterance()
+            , m_lastRing()
+            , m_converter()
+            , m_converted()
+            , m_inputFormat()
+            , m_isConvertible{ true }
+            , m_conversionTime{ 0 }
+            , m_convertedFrames{ 0 }
+            , m_lastInput()
+            , m_lastConversionCost{ 0 }
+            , m_decoder{ VoiceDecoder::Create(settings.decoder) }
+            , m_decoded()
+            , m_isDecoding{ false }
+            , m_decodingTime{ 0 }
+            , m_decodedFrames{ 0 }
+            , m_lastDecodingCost{ 0 }
+            , m_preRollWords{ static_cast<uint64_t>(settings.preRoll.count()) * (AudioFormatCompatibility::SAMPLE_RATE_HZ / 1000) }
+            , m_utteranceEnd{ 0 }
+            , m_preRolled{ 0 }
+            , m_lastPreRoll{ 0 }
+            , m_channelPath{ settings.channel }
+            , m_channel()
+            , m_written{ 0 }
         {
             m_service->AddRef();
         }
@@ -207,7 +372,7 @@ namespace Plugin {
             bool error = false;
 
             if (m_isInitialized) {
-                error = true;
+                return true;
             }
 
             if (error != true) {
@@ -218,18 +383,30 @@ namespace Plugin {
                 }
             }
 
+            if ((error != true) && (m_channelPath.empty() == false)) {
+                m_channel.reset(new SharedAudioChannel(m_channelPath, SHARED_CHANNEL_SIZE));
+                if (m_channel->IsValid() == false) {
+                    TRACE(AVSClient, (_T("Failed to open shared voice channel %s, falling back to COM-RPC"), m_channelPath.c_str()));
+                    m_channel.reset();
+                }
+            }
+
             if (error != true) {
                 m_voiceProducer = m_service->QueryInterfaceByCallsign<WPEFramework::Exchange::IVoiceProducer>(m_callsign);
                 if (m_voiceProducer == nullptr) {
                     TRACE(AVSClient, (_T("Failed to obtain VoiceProducer interface!")));
                     error = true;
-                } else {
-                    m_voiceProducer->Callback((&(*m_voiceHandler)));
                 }
             }
 
             if (error != true) {
+                StartDraining();
+                m_voiceProducer->Callback((&(*m_voiceHandler)));
                 m_isInitialized = true;
+            } else {
+                // Nothing is left behind, the next state change of the audiosource starts over
+                m_channel.reset();
+                m_writer.reset();
             }
 
             return m_isInitialized;
@@ -239,18 +416,358 @@ namespace Plugin {
         {
             const std::lock_guard<std::mutex> lock{ m_mutex };
 
+            StopDraining();
+            m_channel.reset();
+
             if (m_writer) {
                 m_writer.reset();
             }
 
             if (m_voiceProducer) {
                 m_voiceProducer->Release();
+                m_voiceProducer = nullptr;
             }
 
             m_isInitialized = false;
             return true;
         }
 
+        void StartDraining()
+        {
+            if (m_isDraining == false) {
+                m_isDraining = true;
+                m_drainThread = std::thread(&ThunderVoiceHandler::DrainLoop, this);
+            }
+        }
+
+        void StopDraining()
+        {
+            m_isDraining = false;
+            m_drainSignal.notify_one();
+            if (m_drainThread.joinable()) {
+                m_drainThread.join();
+            }
+        }
+
+        // Runs on the COM-RPC thread, must not block
+        void Stage(const uint32_t sequenceNo, const uint8_t data[], const uint16_t length)
+        {
+            if (m_isDraining == true) {
+                if (m_ring.Push(sequenceNo, data, length) == true) {
+                    // No lock taken here on purpose, a missed wake-up is bounded by DRAIN_IDLE_TIMEOUT
+                    m_drainSignal.notify_one();
+                }
+            }
+        }
+
+        // Runs on the COM-RPC thread, must not block. Markers bypass the staging ring, so a full ring
+        // never loses one. A start is only accepted while there is a slot left for its stop as well.
+        bool StageMarker(const uint16_t flags, const StreamFormat& format = StreamFormat())
+        {
+            bool accepted = false;
+
+            if (m_isDraining == true) {
+                const size_t head = m_markerHead.load(std::memory_order_relaxed);
+                const size_t tail = m_markerTail.load(std::memory_order_acquire);
+                const size_t needed = (((flags & UTTERANCE_START) != 0) ? 2 : 1);
+
+                if ((MARKER_SLOTS - (head - tail)) >= needed) {
+                    Marker& marker = m_markers[head % MARKER_SLOTS];
+                    marker.position = m_ring.Head();
+                    marker.flags = flags;
+                    marker.format = format;
+                    m_markerHead.store(head + 1, std::memory_order_release);
+                    m_drainSignal.notify_one();
+                    accepted = true;
+                }
+            }
+
+            return accepted;
+        }
+
+        // Drain thread side, a marker is only handed out once the audio staged in front of it is popped
+        bool PopMarker(Marker& marker)
+        {
+            const size_t tail = m_markerTail.load(std::memory_order_relaxed);
+            bool available = (tail != m_markerHead.load(std::memory_order_acquire));
+
+            if (available == true) {
+                const Marker& front = m_markers[tail % MARKER_SLOTS];
+                available = (front.position <= m_ring.Tail());
+                if (available == true) {
+                    marker = front;
+                    m_markerTail.store(tail + 1, std::memory_order_release);
+                }
+            }
+
+            return available;
+        }
+
+        bool HasMarker() const
+        {
+            return (m_markerHead.load(std::memory_order_acquire) != m_markerTail.load(std::memory_order_relaxed));
+        }
+
+        /// Owns the SDS writer while the handler is initialized and moves staged packets into it.
+        void DrainLoop()
+        {
+            AudioStagingRing::Header header;
+            Marker marker;
+            std::vector<uint8_t> packet(std::numeric_limits<uint16_t>::max());
+            std::vector<uint8_t> concealed(std::numeric_limits<uint16_t>::max());
+
+            m_scheduling.Apply(DRAIN_THREAD_NAME);
+
+            while (m_isDraining == true) {
+                // Markers are checked first, each one waits for the ring audio staged before it. The producer
+                // calls Start() before and Stop() after writing to the shared channel. Sampling the channel
+                // before the markers makes sure a start marker is handled before the packets that follow it,
+                // and the channel is emptied before a stop marker is handled.
+                const bool isChannelReady = ((m_channel) && (m_channel->IsReady() == true));
+
+                if (PopMarker(marker) == true) {
+                    if ((marker.flags & UTTERANCE_START) != 0) {
+                        m_concealer.Reset();
+                        Reconfigure(marker.format);
+                        StartHold();
+                    } else {
+                        while ((m_channel) && (m_channel->Pop(header, packet.data(), static_cast<uint16_t>(packet.size())) == true)) {
+                            Deliver(header, packet.data(), concealed.data());
+                        }
+                        StopHold();
+                        PublishStatistics();
+                    }
+                } else if (m_ring.Pop(header, packet.data(), static_cast<uint16_t>(packet.size())) == true) {
+                    Deliver(header, packet.data(), concealed.data());
+                } else if (isChannelReady == true) {
+                    if (m_channel->Pop(header, packet.data(), static_cast<uint16_t>(packet.size())) == true) {
+                        Deliver(header, packet.data(), concealed.data());
+                    }
+                } else if (m_channel) {
+                    m_channel->Wait(DRAIN_IDLE_TIMEOUT.count());
+                } else {
+                    std::unique_lock<std::mutex> lock{ m_drainMutex };
+                    m_drainSignal.wait_for(lock, DRAIN_IDLE_TIMEOUT, [this]() { return ((m_isDraining == false) || (m_ring.IsEmpty() == false) || (HasMarker() == true)); });
+                }
+            }
+        }
+
+        /// Tracks, decodes and conceals one voice packet and writes the result to the stream.
+        void Deliver(const AudioStagingRing::Header& header, const uint8_t packet[], uint8_t concealed[])
+        {
+            uint32_t missing = 0;
+            if (m_concealer.Track(header.sequenceNo, missing) != PacketLossConcealer::Verdict::LATE) {
+                const uint8_t* frame = packet;
+                uint16_t length = header.length;
+                if (m_isDecoding == true) {
+                    frame = reinterpret_cast<const uint8_t*>(m_decoded.data());
+                    length = Decode(packet, header.length);
+                }
+
+                // Lost frames are concealed in the PCM domain, sized after the packet that follows them
+                for (uint32_t index = 1; index <= missing; ++index) {
+                    m_concealer.Conceal(concealed, length, index);
+                    Write(concealed, length);
+                }
+                Write(frame, length);
+                m_concealer.Remember(frame, length);
+            }
+        }
+
+        /// Starts recognition from the pre-roll window in front of the current writer position.
+        void StartHold()
+        {
+            // The stream keeps everything written since the previous utterance, so the pre-roll
+            // window is spliced straight out of it, without crossing into that utterance
+            if (!m_writer) {
+                return;
+            }
+
+            const uint64_t position = m_writer->tell();
+            uint64_t begin = (position > m_preRollWords) ? (position - m_preRollWords) : 0;
+            begin = std::max(begin, m_utteranceEnd);
+            m_preRolled = position - begin;
+
+            if (m_interactionHandler) {
+                m_interactionHandler->Begin(begin);
+            }
+        }
+
+        void StopHold()
+        {
+            if (!m_writer) {
+                return;
+            }
+
+            m_utteranceEnd = m_writer->tell();
+
+            if (m_interactionHandler) {
+                m_interactionHandler->End();
+            }
+        }
+
+        /// Prepares the conversion stage for the format announced by the producer's profile.
+        void Reconfigure(const StreamFormat& format)
+        {
+            m_conversionTime = 0;
+            m_convertedFrames = 0;
+            m_decodingTime = 0;
+            m_decodedFrames = 0;
+
+            if ((format.codec != m_inputFormat.codec) || (format.sampleRate != m_inputFormat.sampleRate) || (format.channels != m_inputFormat.channels) || (format.resolution != m_inputFormat.resolution)) {
+                m_inputFormat = format;
+                m_isDecoding = false;
+
+                // Decoders always produce 16-bit samples, whatever resolution the profile reports
+                uint8_t resolution = format.resolution;
+                if (format.IsCompressed() == true) {
+                    resolution = AudioFormatCompatibility::SAMPLE_SIZE_IN_BITS;
+                    m_isDecoding = ((m_decoder) && (m_decoder->Configure(format.sampleRate, format.channels) == true));
+                    m_decoded.resize(m_isDecoding ? (std::numeric_limits<uint16_t>::max() / sizeof(int16_t)) : 0);
+
+                    if (m_isDecoding == false) {
+                        TRACE(AVSClient, (_T("Voice input codec %u of %u Hz, %u channels can not be decoded, dropping it"), format.codec, format.sampleRate, format.channels));
+                    }
+                }
+
+                m_isConvertible = (((format.IsCompressed() == false) || (m_isDecoding == true)) && (AudioFormatCompatibility::IsConvertible(format.sampleRate, format.channels, resolution) == true));
+
+                if (m_isConvertible == true) {
+                    const size_t maxFrames = std::numeric_limits<uint16_t>::max() / (sizeof(int16_t) * format.channels);
+                    m_isConvertible = m_converter.Configure(format.sampleRate, format.channels, AudioFormatCompatibility::SAMPLE_RATE_HZ, maxFrames);
+                    m_converted.resize(m_isConvertible ? m_converter.MaxOutputSamples(maxFrames) : 0);
+                }
+
+                if (m_isConvertible == false) {
+                    TRACE(AVSClient, (_T("Voice input of %u Hz, %u channels, %u bits can not be converted, dropping it"), format.sampleRate, format.channels, format.resolution));
+                }
+            } else {
+                m_converter.Reset();
+                if (m_isDecoding == true) {
+                    m_decoder->Reset();
+                }
+            }
+        }
+
+        // Decodes a packet into m_decoded, returns the length of the PCM data in bytes
+        uint16_t Decode(const uint8_t data[], const uint16_t length)
+        {
+            const uint64_t start = ThreadTime();
+            const size_t samples = m_decoder->Decode(data, length, m_decoded.data(), m_decoded.size());
+            m_decodingTime += (ThreadTime() - start);
+            m_decodedFrames += samples / m_inputFormat.channels;
+
+            return static_cast<uint16_t>(samples * sizeof(int16_t));
+        }
+
+        void Write(const uint8_t data[], const uint16_t length)
+        {
+            if ((m_isConvertible == false) || (!m_writer)) {
+                return;
+            }
+
+            ssize_t rc = 0;
+            if (m_converter.IsPassThrough() == true) {
+                // incoming data length = number of bytes
+                size_t nWords = length / m_writer->getWordSize();
+                rc = m_writer->write(data, nWords);
+            } else {
+                const size_t frames = length / (sizeof(int16_t) * m_inputFormat.channels);
+                const uint64_t start = ThreadTime();
+                const size_t samples = m_converter.Process(reinterpret_cast<const int16_t*>(data), frames, m_converted.data(), m_converted.size());
+                m_conversionTime += (ThreadTime() - start);
+                m_convertedFrames += frames;
+                rc = m_writer->write(m_converted.data(), samples);
+            }
+
+            if (rc <= 0) {
+                TRACE(AVSClient, (_T("Failed to write to stream with rc = %d"), rc));
+            } else {
+                m_written.store(m_writer->tell(), std::memory_order_relaxed);
+            }
+        }
+
+        // CPU time consumed by the calling thread, in nanoseconds
+        static uint64_t ThreadTime()
+        {
+            struct timespec now;
+            ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+            return ((static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + now.tv_nsec);
+        }
+
+        void PublishStatistics()
+        {
+            const PacketLossConcealer::Statistics& statistics = m_concealer.Counters();
+            const AudioStagingRing::Statistics ring = m_ring.Counters();
+
+            TRACE(AVSClient, (_T("Utterance: %llu packets, %llu lost, %llu late, %llu discontinuities; staging ring high water %zu/%zu bytes, %llu dropped"),
+                static_cast<unsigned long long>(statistics.receivedPackets),
+                static_cast<unsigned long long>(statistics.lostPackets),
+                static_cast<unsigned long long>(statistics.latePackets),
+                static_cast<unsigned long long>(statistics.discontinuities),
+                ring.highWaterMark, ring.capacity,
+                static_cast<unsigned long long>(ring.droppedPackets)));
+
+            // Microseconds of CPU spent converting one second of input audio
+            uint32_t conversionCost = 0;
+            if ((m_convertedFrames > 0) && (m_inputFormat.sampleRate > 0)) {
+                conversionCost = static_cast<uint32_t>(((m_conversionTime / 1000) * m_inputFormat.sampleRate) / m_convertedFrames);
+                TRACE(AVSClient, (_T("Converted %u Hz/%u channels input at %u us CPU per second of audio"), m_inputFormat.sampleRate, m_inputFormat.channels, conversionCost));
+            }
+
+            // Same for decoding, a measure of the decoder throughput on this device
+            uint32_t decodingCost = 0;
+            if ((m_decodedFrames > 0) && (m_inputFormat.sampleRate > 0)) {
+                decodingCost = static_cast<uint32_t>(((m_decodingTime / 1000) * m_inputFormat.sampleRate) / m_decodedFrames);
+                TRACE(AVSClient, (_T("Decoded %s input at %u us CPU per second of audio"), m_decoder->Name(), decodingCost));
+            }
+
+            const std::lock_guard<std::mutex> lock{ m_statisticsLock };
+            m_lastPreRoll = static_cast<uint32_t>(m_preRolled / (AudioFormatCompatibility::SAMPLE_RATE_HZ / 1000));
+            m_lastUtterance = statistics;
+            m_lastRing = ring;
+            m_lastInput = m_inputFormat;
+            m_lastConversionCost = conversionCost;
+            m_lastDecodingCost = decodingCost;
+        }
+
+    public:
+        uint32_t Statistics(string& statistics) const
+        {
+            static const TCHAR* const strategies[] = { _T("zero"), _T("repeat"), _T("fade") };
+            Diagnostics::VoiceStatistics response;
+
+            {
+                const std::lock_guard<std::mutex> lock{ m_statisticsLock };
+                response.Received = m_lastUtterance.receivedPackets;
+                response.Lost = m_lastUtterance.lostPackets;
+                response.Late = m_lastUtterance.latePackets;
+                response.Discontinuities = m_lastUtterance.discontinuities;
+                response.RingDropped = m_lastRing.droppedPackets;
+                response.RingHighWaterMark = m_lastRing.highWaterMark;
+                response.InputRate = m_lastInput.sampleRate;
+                response.InputChannels = m_lastInput.channels;
+                response.ConversionCost = m_lastConversionCost;
+                response.Codec = ((m_lastInput.IsCompressed() == true) && (m_decoder)) ? m_decoder->Name() : _T("pcm");
+                response.DecodingCost = m_lastDecodingCost;
+                response.PreRoll = m_lastPreRoll;
+            }
+            response.Concealment = strategies[static_cast<uint8_t>(m_concealment)];
+
+            response.ToString(statistics);
+            return WPEFramework::Core::ERROR_NONE;
+        }
+
+        void Memory(Diagnostics::MemoryStatistics& statistics) const
+        {
+            const AudioStagingRing::Statistics ring = m_ring.Counters();
+            const uint64_t written = std::min<uint64_t>(m_written.load(std::memory_order_relaxed), m_audioInputStream->getDataSize());
+
+            statistics.HighWaterMark = written * m_audioInputStream->getWordSize();
+            statistics.StagingRingSize = ring.capacity;
+            statistics.StagingRingHighWaterMark = ring.highWaterMark;
+        }
+
     private:
         ///  Responsible for getting audio data from Thunder
         class VoiceHandler : public WPEFramework::Exchange::IVoiceHandler {
@@ -270,15 +787,25 @@ namespace Plugin {
 
                 if (m_isStarted == true) {
                     TRACE(AVSClient, (_T("The audiotransmission is already started. Skipping...")));
-                } else {
-                    m_isStarted = true;
-                    m_profile = profile;
-                    if (m_profile) {
-                        m_profile->AddRef();
+                } else if (m_parent) {
+                    StreamFormat format;
+                    if (profile) {
+                        format.codec = profile->Codec();
+                        format.sampleRate = profile->SampleRate();
+                        format.channels = profile->Channels();
+                        format.resolution = profile->Resolution();
                     }
 
-                    if (m_parent && m_parent->m_interactionHandler) {
-                        m_parent->m_interactionHandler->HoldToTalk();
+                    // Hold-to-talk is started by the drain thread, once it knows where this utterance begins in the stream.
+                    // Starts and stops alternate, an accepted start always has room for its stop.
+                    m_isStarted = m_parent->StageMarker(UTTERANCE_START, format);
+                    if (m_isStarted == true) {
+                        m_profile = profile;
+                        if (m_profile) {
+                            m_profile->AddRef();
+                        }
+                    } else {
+                        TRACE(AVSClient, (_T("Voice input is not drained, skipping the audiotransmission")));
                     }
                 }
             }
@@ -294,8 +821,8 @@ namespace Plugin {
                     m_profile = nullptr;
                 }
 
-                if (m_parent && m_parent->m_interactionHandler) {
-                    m_parent->m_interactionHandler->HoldToTalk();
+                if ((m_isStarted == true) && (m_parent)) {
+                    m_parent->StageMarker(UTTERANCE_STOP);
                 }
 
                 m_isStarted = false;
@@ -303,15 +830,8 @@ namespace Plugin {
 
             void Data(const uint32_t sequenceNo, const uint8_t data[], const uint16_t length) override
             {
-                TRACE_L1(_T("ThunderVoiceHandler::VoiceHandler::Data()"));
-
-                if (m_parent && m_parent->m_writer) {
-                    // incoming data length = number of bytes
-                    size_t nWords = length / m_parent->m_writer->getWordSize();
-                    ssize_t rc = m_parent->m_writer->write(data, nWords);
-                    if (rc <= 0) {
-                        TRACE(AVSClient, (_T("Failed to write to stream with rc = %d"), rc));
-                    }
+                if (m_parent) {
+                    m_parent->Stage(sequenceNo, data, length);
                 }
             }
 
@@ -326,6 +846,21 @@ namespace Plugin {
         };
 
     private:
+        // Two seconds of the largest accepted input, 48 kHz/16-bit with 8 channels. Packet headers
+        // are left out, they add less than 1% for packets of 10 ms or longer.
+        static constexpr size_t STAGING_RING_SECONDS = 2;
+        static constexpr size_t STAGING_RING_SIZE = STAGING_RING_SECONDS * AudioFormatCompatibility::MAX_INPUT_SAMPLE_RATE_HZ * AudioFormatCompatibility::MAX_INPUT_CHANNELS * (AudioFormatCompatibility::SAMPLE_SIZE_IN_BITS / 8);
+        static constexpr uint32_t SHARED_CHANNEL_SIZE = 64 * 1024;
+        static constexpr std::chrono::milliseconds DRAIN_IDLE_TIMEOUT = std::chrono::milliseconds(10);
+        static constexpr const char* DRAIN_THREAD_NAME = "AVSVoiceDrain";
+        static constexpr size_t MARKER_SLOTS = 8;
+
+        // Utterance boundaries, posted next to the audio so the drain thread sees them in order
+        enum : uint16_t {
+            UTTERANCE_START = 0x0001,
+            UTTERANCE_STOP = 0x0002
+        };
+
         const std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream> m_audioInputStream;
         std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream::Writer> m_writer;
         std::shared_ptr<InteractionHandler<MANAGER>> m_interactionHandler;
@@ -337,7 +872,67 @@ namespace Plugin {
         bool m_isInitialized;
         std::mutex m_mutex;
         string m_callsign;
+
+        AudioStagingRing m_ring;
+        Marker m_markers[MARKER_SLOTS];
+        std::atomic<size_t> m_markerHead;
+        std::atomic<size_t> m_markerTail;
+        std::atomic<bool> m_isDraining;
+        std::thread m_drainThread;
+        std::mutex m_drainMutex;
+        std::condition_variable m_drainSignal;
+        const ThreadScheduling m_scheduling;
+
+        PacketLossConcealer m_concealer;
+        const PacketLossConcealer::Strategy m_concealment;
+        mutable std::mutex m_statisticsLock;
+        PacketLossConcealer::Statistics m_lastUtterance;
+        AudioStagingRing::Statistics m_lastRing;
+
+        // Conversion stage, only touched by the drain thread
+        AudioConverter m_converter;
+        std::vector<int16_t> m_converted;
+        StreamFormat m_inputFormat;
+        bool m_isConvertible;
+        uint64_t m_conversionTime;
+        uint64_t m_convertedFrames;
+        StreamFormat m_lastInput;
+        uint32_t m_lastConversionCost;
+
+        // Decoding stage of compressed profiles, only touched by the drain thread
+        std::unique_ptr<VoiceDecoder> m_decoder;
+        std::vector<int16_t> m_decoded;
+        bool m_isDecoding;
+        uint64_t m_decodingTime;
+        uint64_t m_decodedFrames;
+        uint32_t m_lastDecodingCost;
+
+        // Pre-roll splicing, in SDS words
+        const uint64_t m_preRollWords;
+        uint64_t m_utteranceEnd;
+        uint64_t m_preRolled;
+        uint32_t m_lastPreRoll;
+
+        // Optional shared memory delivery, read by the drain thread next to the staging ring
+        const string m_channelPath;
+        std::unique_ptr<SharedAudioChannel> m_channel;
+
+        // Writer position, the stream has been filled up to this many words
+        std::atomic<uint64_t> m_written;
     };
 
+    template <typename MANAGER>
+    constexpr size_t ThunderVoiceHandler<MANAGER>::STAGING_RING_SECONDS;
+    template <typename MANAGER>
+    constexpr size_t ThunderVoiceHandler<MANAGER>::STAGING_RING_SIZE;
+    template <typename MANAGER>
+    constexpr uint32_t ThunderVoiceHandler<MANAGER>::SHARED_CHANNEL_SIZE;
+    template <typename MANAGER>
+    constexpr std::chrono::milliseconds ThunderVoiceHandler<MANAGER>::DRAIN_IDLE_TIMEOUT;
+    template <typename MANAGER>
+    constexpr const char* ThunderVoiceHandler<MANAGER>::DRAIN_THREAD_NAME;
+    template <typename MANAGER>
+    constexpr size_t ThunderVoiceHandler<MANAGER>::MARKER_SLOTS;
+
 } // namespace Plugin
 } // namespace WPEFramework
@@ -21,81 +21,118 @@
 
 #include "Module.h"
 
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
 namespace WPEFramework {
 namespace Plugin {
 
     /**
-     * Trace category for logs coming directly from the AVS SDK
+     * Trace category keeping its text in an inline buffer of CAPACITY characters.
+     *
+     * Nothing is allocated: text that does not fit is cut off. Nothing is formatted either when
+     * the category is disabled in the trace controller. TRACE() does not create the category
+     * then in the first place, the check here covers the categories created outside of it.
+     *
+     * CATEGORY is the class deriving from it, its name is the name of the trace category.
      */
-    class AVSSDK {
+    template <typename CATEGORY, uint16_t CAPACITY>
+    class TraceCategory {
     public:
-        AVSSDK() = delete;
-        AVSSDK(const AVSSDK& a_Copy) = delete;
-        AVSSDK& operator=(const AVSSDK& a_RHS) = delete;
-        ~AVSSDK() = default;
+        TraceCategory(const TraceCategory&) = delete;
+        TraceCategory& operator=(const TraceCategory&) = delete;
 
-        explicit AVSSDK(const string& text)
-            : _text(WPEFramework::Core::ToString(text))
+        inline const char* Data() const
         {
+            return (_text);
         }
 
-        AVSSDK(const TCHAR formatter[], ...)
+        inline uint16_t Length() const
         {
-            va_list ap;
-            va_start(ap, formatter);
-            Trace::Format(_text, formatter, ap);
-            va_end(ap);
+            return (_length);
         }
 
-        inline const char* Data() const
+        static inline bool IsEnabled()
         {
-            return (_text.c_str());
+            return (Trace::TraceType<CATEGORY, &Core::System::MODULE_NAME>::IsEnabled());
         }
 
-        inline uint16_t Length() const
+    protected:
+        TraceCategory()
+            : _length(0)
         {
-            return (static_cast<uint16_t>(_text.length()));
+            _text[0] = '\0';
+        }
+        ~TraceCategory() = default;
+
+        void Copy(const string& text)
+        {
+            if (IsEnabled() == true) {
+                _length = static_cast<uint16_t>(std::min(text.length(), static_cast<size_t>(CAPACITY - 1)));
+                ::memcpy(_text, text.c_str(), _length);
+                _text[_length] = '\0';
+            }
+        }
+
+        void Format(const TCHAR formatter[], va_list ap)
+        {
+            if (IsEnabled() == true) {
+                const int length = ::vsnprintf(_text, CAPACITY, formatter, ap);
+                _length = static_cast<uint16_t>(std::max(0, std::min(length, CAPACITY - 1)));
+            }
         }
 
     private:
-        std::string _text;
+        static_assert(CAPACITY > 1, "A trace category needs room for its text");
+
+        uint16_t _length;
+        char _text[CAPACITY];
     };
 
     /**
-     * Trace category for logs coming from the AVS plugin and implementation
-    */
-    class AVSClient {
+     * Trace category for logs coming directly from the AVS SDK
+     */
+    class AVSSDK : public TraceCategory<AVSSDK, 512> {
     public:
-        AVSClient() = delete;
-        AVSClient(const AVSClient& a_Copy) = delete;
-        AVSClient& operator=(const AVSClient& a_RHS) = delete;
-        ~AVSClient() = default;
+        AVSSDK() = delete;
+        ~AVSSDK() = default;
 
-        explicit AVSClient(const string& text)
-            : _text(WPEFramework::Core::ToString(text))
+        explicit AVSSDK(const string& text)
         {
+            Copy(text);
         }
 
-        AVSClient(const TCHAR formatter[], ...)
+        AVSSDK(const TCHAR formatter[], ...)
         {
             va_list ap;
             va_start(ap, formatter);
-            Trace::Format(_text, formatter, ap);
+            Format(formatter, ap);
             va_end(ap);
         }
+    };
 
-        inline const char* Data() const
+    /**
+     * Trace category for logs coming from the AVS plugin and implementation
+    */
+    class AVSClient : public TraceCategory<AVSClient, 256> {
+    public:
+        AVSClient() = delete;
+        ~AVSClient() = default;
+
+        explicit AVSClient(const string& text)
         {
-            return (_text.c_str());
+            Copy(text);
         }
 
-        inline uint16_t Length() const
+        AVSClient(const TCHAR formatter[], ...)
         {
-            return (static_cast<uint16_t>(_text.length()));
+            va_list ap;
+            va_start(ap, formatter);
+            Format(formatter, ap);
+            va_end(ap);
         }
-
-    private:
-        std::string _text;
     };
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,63 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VoiceDecoder.h"
+#include "ImaAdpcmDecoder.h"
+#if defined(VOICE_DECODER_OPUS)
+#include "OpusVoiceDecoder.h"
+#endif
+
+namespace WPEFramework {
+namespace Plugin {
+
+    namespace {
+
+        template <typename DECODER>
+        std::unique_ptr<VoiceDecoder> Make()
+        {
+            return std::unique_ptr<VoiceDecoder>(new DECODER());
+        }
+
+        struct Entry {
+            const char* name;
+            std::unique_ptr<VoiceDecoder> (*create)();
+        };
+
+        // A new codec is added by implementing VoiceDecoder and listing it here
+        const Entry DECODERS[] = {
+            { "ima-adpcm", &Make<ImaAdpcmDecoder> },
+#if defined(VOICE_DECODER_OPUS)
+            { "opus", &Make<OpusVoiceDecoder> },
+#endif
+        };
+
+    } // namespace
+
+    std::unique_ptr<VoiceDecoder> VoiceDecoder::Create(const std::string& name)
+    {
+        for (const Entry& entry : DECODERS) {
+            if (name == entry.name) {
+                return entry.create();
+            }
+        }
+        return nullptr;
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
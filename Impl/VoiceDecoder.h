@@ -0,0 +1,58 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /**
+     * Decoder of compressed voice packets into 16-bit interleaved PCM.
+     *
+     * Every packet handed to Decode() is one complete codec frame, as delivered by
+     * IVoiceHandler::Data(). Implementations acquire their state in Configure(), Decode()
+     * must not allocate.
+     */
+    class VoiceDecoder {
+    public:
+        VoiceDecoder(const VoiceDecoder&) = delete;
+        VoiceDecoder& operator=(const VoiceDecoder&) = delete;
+
+        VoiceDecoder() = default;
+        virtual ~VoiceDecoder() = default;
+
+        /// Creates the decoder registered under name, nullptr if there is none.
+        static std::unique_ptr<VoiceDecoder> Create(const std::string& name);
+
+    public:
+        virtual const char* Name() const = 0;
+        virtual bool Configure(const uint32_t sampleRate, const uint8_t channels) = 0;
+        virtual void Reset() = 0;
+
+        /// Decodes one packet, returns the number of interleaved samples written to output.
+        virtual size_t Decode(const uint8_t data[], const uint16_t length, int16_t output[], const size_t capacity) = 0;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
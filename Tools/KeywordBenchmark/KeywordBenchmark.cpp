@@ -0,0 +1,708 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Offline benchmark of the wake word detector.
+ *
+ * Feeds a directory of labelled recordings through a KeywordDetector engine, once per detection
+ * threshold, as fast as the detector consumes them. Recordings are 16 kHz, 16-bit mono, either
+ * WAV or headerless (.raw). The keywords in a recording are listed in a file with the same name
+ * and the .lab extension, one keyword per line: its end time in milliseconds, or its begin and
+ * end time separated by a space. A recording without labels holds no keyword.
+ *
+ * The report, in JSON, lists per threshold the false accepts and false rejects, the latency from
+ * the end of the keyword until it is reported, and the CPU time spent per hour of audio. It also
+ * checks the keyword boundaries the detector reports against the labels: the recordings are
+ * replayed at a stream position unrelated to the decoder's own sample count, so any error in
+ * mapping the decoder's indices to the stream shows up as a boundary error.
+ *
+ * A run over silence alone follows, at the first threshold, so its idle cost can be held
+ * against the processing cost of the recordings: what the detector costs while nobody speaks.
+ */
+
+#include "Module.h"
+
+#include "AudioStreamBuffer.h"
+#include "CompatibleAudioFormat.h"
+#include "KeywordDetector.h"
+
+#include <AVSCommon/Utils/Configuration/ConfigurationNode.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <dirent.h>
+#include <getopt.h>
+#include <time.h>
+
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+using namespace WPEFramework;
+using namespace alexaClientSDK::avsCommon;
+
+namespace {
+
+    using Index = avs::AudioInputStream::Index;
+
+    constexpr uint32_t SAMPLES_PER_MILLISECOND = Plugin::AudioFormatCompatibility::SAMPLE_RATE_HZ / 1000;
+    // Silence written before the first recording, lets a locale or keyword switch complete
+    constexpr uint32_t LEAD_IN = 2000;
+    // Silence written after each recording, so a detection can not carry over to the next one
+    constexpr uint32_t GAP = 1000;
+    // A detection this long before or after a labelled keyword end counts as detecting it
+    constexpr uint32_t EARLY_WINDOW = 500;
+    constexpr uint32_t LATE_WINDOW = 1000;
+    // Milliseconds without progress after which the detector is considered dead
+    constexpr uint32_t STALL_TIMEOUT = 5000;
+    // Samples per write, 10 ms like a microphone
+    constexpr size_t CHUNK = 10 * SAMPLES_PER_MILLISECOND;
+    // Seconds of the silence run
+    constexpr uint32_t DEFAULT_SILENCE = 60;
+
+    struct Label {
+        uint32_t begin;
+        uint32_t end;
+        bool hasBegin;
+    };
+
+    struct Recording {
+        std::string name;
+        std::vector<int16_t> samples;
+        std::vector<Label> keywords;
+    };
+
+    struct Keyword {
+        Index begin;
+        Index end;
+        bool hasBegin;
+    };
+
+    struct Detection {
+        // Read position of the detector when the keyword was reported
+        Index position;
+        // Keyword boundaries as reported to the observers
+        Index begin;
+        Index end;
+        bool isMatched;
+    };
+
+    class Observer : public sdkInterfaces::KeyWordObserverInterface {
+    public:
+        Observer(const Observer&) = delete;
+        Observer& operator=(const Observer&) = delete;
+
+        Observer()
+            : _detector(nullptr)
+            , _lock()
+            , _detections()
+        {
+        }
+        ~Observer() override = default;
+
+    public:
+        void Detector(const Plugin::KeywordDetector* detector)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _detector = detector;
+        }
+
+        void onKeyWordDetected(std::shared_ptr<avs::AudioInputStream>, std::string, Index begin, Index end, std::shared_ptr<const std::vector<char>>) override
+        {
+            // Called on the detection thread, so the read position is where the keyword was recognised
+            std::lock_guard<std::mutex> lock(_lock);
+            if (_detector != nullptr) {
+                _detections.push_back({ _detector->Position(), begin, end, false });
+            }
+        }
+
+        std::vector<Detection> Detections()
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            return (_detections);
+        }
+
+    private:
+        const Plugin::KeywordDetector* _detector;
+        std::mutex _lock;
+        std::vector<Detection> _detections;
+    };
+
+    class ThresholdReport : public Core::JSON::Container {
+    public:
+        ThresholdReport(const ThresholdReport& copy)
+            : Core::JSON::Container()
+            , Threshold(copy.Threshold)
+            , Detections(copy.Detections)
+            , FalseAccepts(copy.FalseAccepts)
+            , FalseRejects(copy.FalseRejects)
+            , FalseAcceptsPerHour(copy.FalseAcceptsPerHour)
+            , FalseRejectRate(copy.FalseRejectRate)
+            , LatencyAverage(copy.LatencyAverage)
+            , LatencyMaximum(copy.LatencyMaximum)
+            , CpuPerAudioHour(copy.CpuPerAudioHour)
+            , RealTimeFactor(copy.RealTimeFactor)
+            , ProcessingCost(copy.ProcessingCost)
+            , IdleCost(copy.IdleCost)
+            , EndErrorAverage(copy.EndErrorAverage)
+            , EndErrorMaximum(copy.EndErrorMaximum)
+            , BeginErrorAverage(copy.BeginErrorAverage)
+            , BeginErrorMaximum(copy.BeginErrorMaximum)
+            , Gated(copy.Gated)
+        {
+            Init();
+        }
+
+        ThresholdReport()
+            : Core::JSON::Container()
+            , Threshold()
+            , Detections()
+            , FalseAccepts()
+            , FalseRejects()
+            , FalseAcceptsPerHour()
+            , FalseRejectRate()
+            , LatencyAverage()
+            , LatencyMaximum()
+            , CpuPerAudioHour()
+            , RealTimeFactor()
+            , ProcessingCost()
+            , IdleCost()
+            , EndErrorAverage()
+            , EndErrorMaximum()
+            , BeginErrorAverage()
+            , BeginErrorMaximum()
+            , Gated()
+        {
+            Init();
+        }
+
+        ~ThresholdReport() override = default;
+
+    private:
+        void Init()
+        {
+            Add(_T("threshold"), &Threshold);
+            Add(_T("detections"), &Detections);
+            Add(_T("falseaccepts"), &FalseAccepts);
+            Add(_T("falserejects"), &FalseRejects);
+            Add(_T("falseacceptsperhour"), &FalseAcceptsPerHour);
+            Add(_T("falserejectrate"), &FalseRejectRate);
+            Add(_T("latencyaverage"), &LatencyAverage);
+            Add(_T("latencymaximum"), &LatencyMaximum);
+            Add(_T("cpuperaudiohour"), &CpuPerAudioHour);
+            Add(_T("realtimefactor"), &RealTimeFactor);
+            Add(_T("processingcost"), &ProcessingCost);
+            Add(_T("idlecost"), &IdleCost);
+            Add(_T("enderroraverage"), &EndErrorAverage);
+            Add(_T("enderrormaximum"), &EndErrorMaximum);
+            Add(_T("beginerroraverage"), &BeginErrorAverage);
+            Add(_T("beginerrormaximum"), &BeginErrorMaximum);
+            Add(_T("gated"), &Gated);
+        }
+
+    public:
+        Core::JSON::DecUInt32 Threshold;
+        Core::JSON::DecUInt32 Detections;
+        Core::JSON::DecUInt32 FalseAccepts;
+        Core::JSON::DecUInt32 FalseRejects;
+        Core::JSON::Float FalseAcceptsPerHour;
+        Core::JSON::Float FalseRejectRate;
+        Core::JSON::DecSInt32 LatencyAverage;
+        Core::JSON::DecSInt32 LatencyMaximum;
+        Core::JSON::Float CpuPerAudioHour;
+        Core::JSON::Float RealTimeFactor;
+        // Microseconds per second of audio, of all of it and of the audio without voice activity
+        Core::JSON::DecUInt32 ProcessingCost;
+        Core::JSON::DecUInt32 IdleCost;
+        // Reported minus labelled keyword boundary in milliseconds, the maximum is of the magnitude
+        Core::JSON::DecSInt32 EndErrorAverage;
+        Core::JSON::DecUInt32 EndErrorMaximum;
+        Core::JSON::DecSInt32 BeginErrorAverage;
+        Core::JSON::DecUInt32 BeginErrorMaximum;
+        // Milliseconds of audio the cascade kept from the engine
+        Core::JSON::DecUInt64 Gated;
+    };
+
+    class Report : public Core::JSON::Container {
+    public:
+        Report(const Report&) = delete;
+        Report& operator=(const Report&) = delete;
+
+        Report()
+            : Core::JSON::Container()
+            , Engine()
+            , Cascade()
+            , Locale()
+            , Keyword()
+            , Recordings()
+            , Keywords()
+            , Audio()
+            , Thresholds()
+            , Silence()
+        {
+            Add(_T("engine"), &Engine);
+            Add(_T("cascade"), &Cascade);
+            Add(_T("locale"), &Locale);
+            Add(_T("keyword"), &Keyword);
+            Add(_T("recordings"), &Recordings);
+            Add(_T("keywords"), &Keywords);
+            Add(_T("audio"), &Audio);
+            Add(_T("thresholds"), &Thresholds);
+            Add(_T("silence"), &Silence);
+        }
+
+        ~Report() override = default;
+
+    public:
+        Core::JSON::String Engine;
+        Core::JSON::Boolean Cascade;
+        Core::JSON::String Locale;
+        Core::JSON::String Keyword;
+        Core::JSON::DecUInt32 Recordings;
+        Core::JSON::DecUInt32 Keywords;
+        Core::JSON::DecUInt32 Audio;
+        Core::JSON::ArrayType<ThresholdReport> Thresholds;
+        ThresholdReport Silence;
+    };
+
+    uint64_t WallTime()
+    {
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return ((static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + now.tv_nsec);
+    }
+
+    bool EndsWith(const std::string& name, const std::string& suffix)
+    {
+        return ((name.size() > suffix.size()) && (name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0));
+    }
+
+    template <typename TYPE>
+    TYPE Little(const uint8_t data[])
+    {
+        TYPE value = 0;
+        for (size_t i = 0; i < sizeof(TYPE); ++i) {
+            value |= static_cast<TYPE>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // Returns the PCM payload of a 16 kHz 16-bit mono WAV file
+    bool ReadWave(const std::vector<uint8_t>& file, std::vector<int16_t>& samples)
+    {
+        if ((file.size() < 12) || (::memcmp(&file[0], "RIFF", 4) != 0) || (::memcmp(&file[8], "WAVE", 4) != 0)) {
+            return false;
+        }
+
+        bool isFormatValid = false;
+        size_t offset = 12;
+        while ((offset + 8) <= file.size()) {
+            const uint32_t length = Little<uint32_t>(&file[offset + 4]);
+            const size_t payload = offset + 8;
+            if ((::memcmp(&file[offset], "fmt ", 4) == 0) && (length >= 16) && ((payload + 16) <= file.size())) {
+                isFormatValid = ((Little<uint16_t>(&file[payload]) == 1)
+                    && (Little<uint16_t>(&file[payload + 2]) == 1)
+                    && (Little<uint32_t>(&file[payload + 4]) == Plugin::AudioFormatCompatibility::SAMPLE_RATE_HZ)
+                    && (Little<uint16_t>(&file[payload + 14]) == 16));
+            } else if ((::memcmp(&file[offset], "data", 4) == 0) && (isFormatValid == true)) {
+                const size_t available = std::min<size_t>(length, file.size() - payload) / sizeof(int16_t);
+                samples.resize(available);
+                ::memcpy(samples.data(), &file[payload], available * sizeof(int16_t));
+                return true;
+            }
+            offset = payload + length + (length & 1);
+        }
+
+        return false;
+    }
+
+    bool Load(const std::string& directory, const std::string& name, Recording& recording)
+    {
+        std::ifstream input(directory + "/" + name, std::ios::binary);
+        const std::vector<uint8_t> file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+        recording.name = name;
+        if (EndsWith(name, ".wav") == true) {
+            if (ReadWave(file, recording.samples) == false) {
+                fprintf(stderr, "Skipping %s: not a 16 kHz 16-bit mono PCM WAV file\n", name.c_str());
+                return false;
+            }
+        } else {
+            recording.samples.resize(file.size() / sizeof(int16_t));
+            ::memcpy(recording.samples.data(), file.data(), recording.samples.size() * sizeof(int16_t));
+        }
+
+        std::ifstream labels(directory + "/" + name.substr(0, name.rfind('.')) + ".lab");
+        std::string line;
+        while (std::getline(labels, line)) {
+            if ((line.empty() == false) && (line[0] != '#')) {
+                std::istringstream times(line);
+                Label label = { 0, 0, false };
+                times >> label.end;
+                if (times >> label.begin) {
+                    std::swap(label.begin, label.end);
+                    label.hasBegin = true;
+                }
+                recording.keywords.push_back(label);
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<Recording> LoadAll(const std::string& directory)
+    {
+        std::vector<std::string> names;
+        DIR* handle = ::opendir(directory.c_str());
+        if (handle != nullptr) {
+            struct dirent* entry;
+            while ((entry = ::readdir(handle)) != nullptr) {
+                const std::string name(entry->d_name);
+                if ((EndsWith(name, ".wav") == true) || (EndsWith(name, ".raw") == true)) {
+                    names.push_back(name);
+                }
+            }
+            ::closedir(handle);
+        }
+        std::sort(names.begin(), names.end());
+
+        std::vector<Recording> recordings;
+        for (const std::string& name : names) {
+            Recording recording;
+            if (Load(directory, name, recording) == true) {
+                recordings.push_back(std::move(recording));
+            }
+        }
+        return recordings;
+    }
+
+    void Write(avs::AudioInputStream::Writer& writer, const int16_t samples[], const size_t count)
+    {
+        size_t written = 0;
+        while (written < count) {
+            const size_t chunk = std::min(CHUNK, count - written);
+            const ssize_t result = writer.write(&samples[written], chunk);
+            if (result > 0) {
+                written += result;
+            } else if (result == avs::AudioInputStream::Writer::Error::WOULDBLOCK) {
+                // The stream is full of audio the detector has not read yet
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } else {
+                fprintf(stderr, "Failed to write to the audio stream (%zd)\n", result);
+                break;
+            }
+        }
+    }
+
+    void Silence(avs::AudioInputStream::Writer& writer, const uint32_t milliseconds)
+    {
+        const std::vector<int16_t> silence(milliseconds * SAMPLES_PER_MILLISECOND, 0);
+        Write(writer, silence.data(), silence.size());
+    }
+
+    bool Run(const std::vector<Recording>& recordings, const std::string& engine, const bool cascade, const std::string& modelsPath, const std::string& locale, const std::string& keyword, const uint32_t threshold, ThresholdReport& report)
+    {
+        Plugin::AudioStreamSettings settings;
+        settings.readers = 2;
+        Plugin::AudioStreamBuffer buffer;
+        std::shared_ptr<avs::AudioInputStream> stream = buffer.Create(settings, Plugin::AudioFormatCompatibility::SAMPLE_RATE_HZ);
+        if (!stream) {
+            return false;
+        }
+
+        // The writer never overruns the detector, so the audio goes through as fast as it is consumed
+        std::shared_ptr<avs::AudioInputStream::Writer> writer = stream->createWriter(avs::AudioInputStream::Writer::Policy::NONBLOCKING);
+
+        utils::AudioFormat format;
+        format.encoding = utils::AudioFormat::Encoding::LPCM;
+        format.endianness = utils::AudioFormat::Endianness::LITTLE;
+        format.sampleRateHz = Plugin::AudioFormatCompatibility::SAMPLE_RATE_HZ;
+        format.sampleSizeInBits = Plugin::AudioFormatCompatibility::SAMPLE_SIZE_IN_BITS;
+        format.numChannels = Plugin::AudioFormatCompatibility::NUM_CHANNELS;
+
+        auto observer = std::make_shared<Observer>();
+        std::unique_ptr<Plugin::KeywordDetector> detector = Plugin::KeywordDetector::Create(
+            engine, stream, format, { observer }, {}, modelsPath);
+        if (!detector) {
+            return false;
+        }
+        observer->Detector(detector.get());
+        detector->Cascade(cascade);
+
+        if (((locale.empty() == false) && (detector->SetLocale(locale) == false))
+            || ((keyword.empty() == false) && (detector->SetKeyword(keyword) == false))
+            || (detector->SetThreshold(threshold) == false)) {
+            return false;
+        }
+
+        const uint64_t start = WallTime();
+        std::vector<Keyword> keywords;
+
+        Silence(*writer, LEAD_IN);
+        for (const Recording& recording : recordings) {
+            const Index begin = writer->tell();
+            for (const Label& label : recording.keywords) {
+                keywords.push_back({ begin + (static_cast<Index>(label.begin) * SAMPLES_PER_MILLISECOND), begin + (static_cast<Index>(label.end) * SAMPLES_PER_MILLISECOND), label.hasBegin });
+            }
+            Write(*writer, recording.samples.data(), recording.samples.size());
+            Silence(*writer, GAP);
+        }
+
+        // Wait for the detector to catch up with the writer
+        const Index written = writer->tell();
+        Index position = detector->Position();
+        uint32_t stalled = 0;
+        while ((position < written) && (stalled < STALL_TIMEOUT)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            const Index now = detector->Position();
+            stalled = (now == position) ? (stalled + 10) : 0;
+            position = now;
+        }
+        const uint64_t elapsed = WallTime() - start;
+
+        Plugin::Diagnostics::KeywordStatistics statistics;
+        detector->Statistics(statistics);
+        detector.reset();
+
+        if (position < written) {
+            fprintf(stderr, "The detector stopped reading after %llu of %llu samples\n", static_cast<unsigned long long>(position), static_cast<unsigned long long>(written));
+            return false;
+        }
+
+        std::vector<Detection> detections = observer->Detections();
+        uint32_t falseRejects = 0;
+        int64_t latencySum = 0;
+        int64_t latencyMaximum = 0;
+        uint32_t accepts = 0;
+        int64_t endErrorSum = 0;
+        int64_t endErrorMaximum = 0;
+        int64_t beginErrorSum = 0;
+        int64_t beginErrorMaximum = 0;
+        uint32_t begins = 0;
+
+        for (const Keyword& keyword : keywords) {
+            const Index end = keyword.end;
+            auto match = std::find_if(detections.begin(), detections.end(), [end](const Detection& detection) {
+                return ((detection.isMatched == false)
+                    && ((detection.position + (EARLY_WINDOW * SAMPLES_PER_MILLISECOND)) >= end)
+                    && (detection.position <= (end + (LATE_WINDOW * SAMPLES_PER_MILLISECOND))));
+            });
+            if (match == detections.end()) {
+                falseRejects++;
+            } else {
+                const int64_t latency = (static_cast<int64_t>(match->position) - static_cast<int64_t>(end)) / SAMPLES_PER_MILLISECOND;
+                match->isMatched = true;
+                latencySum += latency;
+                latencyMaximum = std::max(latencyMaximum, latency);
+                accepts++;
+
+                const int64_t endError = (static_cast<int64_t>(match->end) - static_cast<int64_t>(keyword.end)) / SAMPLES_PER_MILLISECOND;
+                endErrorSum += endError;
+                endErrorMaximum = std::max(endErrorMaximum, std::abs(endError));
+                if (keyword.hasBegin == true) {
+                    const int64_t beginError = (static_cast<int64_t>(match->begin) - static_cast<int64_t>(keyword.begin)) / SAMPLES_PER_MILLISECOND;
+                    beginErrorSum += beginError;
+                    beginErrorMaximum = std::max(beginErrorMaximum, std::abs(beginError));
+                    begins++;
+                }
+            }
+        }
+
+        const uint32_t falseAccepts = static_cast<uint32_t>(detections.size()) - accepts;
+        const double hours = static_cast<double>(statistics.Audio.Value()) / (3600.0 * 1000.0);
+
+        report.Threshold = threshold;
+        report.Detections = static_cast<uint32_t>(detections.size());
+        report.FalseAccepts = falseAccepts;
+        report.FalseRejects = falseRejects;
+        report.FalseAcceptsPerHour = (hours > 0) ? static_cast<float>(falseAccepts / hours) : 0.0f;
+        report.FalseRejectRate = (keywords.empty() == false) ? (static_cast<float>(falseRejects) / keywords.size()) : 0.0f;
+        report.LatencyAverage = (accepts > 0) ? static_cast<int32_t>(latencySum / accepts) : 0;
+        report.LatencyMaximum = static_cast<int32_t>(latencyMaximum);
+        // processingcost is in microseconds per second of audio
+        report.CpuPerAudioHour = static_cast<float>(statistics.ProcessingCost.Value()) * 3600.0f / 1000000.0f;
+        report.RealTimeFactor = (elapsed > 0) ? static_cast<float>((statistics.Audio.Value() * 1000000.0) / elapsed) : 0.0f;
+        report.ProcessingCost = statistics.ProcessingCost.Value();
+        report.IdleCost = statistics.IdleCost.Value();
+        report.EndErrorAverage = (accepts > 0) ? static_cast<int32_t>(endErrorSum / accepts) : 0;
+        report.EndErrorMaximum = static_cast<uint32_t>(endErrorMaximum);
+        report.BeginErrorAverage = (begins > 0) ? static_cast<int32_t>(beginErrorSum / begins) : 0;
+        report.BeginErrorMaximum = static_cast<uint32_t>(beginErrorMaximum);
+        report.Gated = statistics.Gated.Value();
+
+        return true;
+    }
+
+    void Usage(const char* name)
+    {
+        fprintf(stderr,
+            "Usage: %s [-e <engine>] [-g] [-c <sdk config>] -m <models path> -d <recordings> [-t <threshold>[,<threshold>...]] [-l <locale>] [-k <keyword>] [-s <seconds>] [-o <report>]\n"
+            "  -e  Keyword detection engine, %s when not given\n"
+            "  -g  Cascade the engine behind the audio level gate\n"
+            "  -c  AVS SDK configuration holding the localeToModels section, for the engines that need it\n"
+            "  -m  Directory of the wake word models\n"
+            "  -d  Directory of the recordings and their .lab files\n"
+            "  -t  Detection thresholds to evaluate, 200 when not given\n"
+            "  -l  Locale of the model, the default locale when not given\n"
+            "  -k  Keyword to detect, the default keyword when not given\n"
+            "  -s  Seconds of the silence run, %u when not given, 0 to leave it out\n"
+            "  -o  File to write the report to, stdout when not given\n",
+            name, Plugin::KeywordDetector::DEFAULT_ENGINE, DEFAULT_SILENCE);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string engine(Plugin::KeywordDetector::DEFAULT_ENGINE);
+    bool cascade = false;
+    std::string configPath;
+    std::string modelsPath;
+    std::string recordingsPath;
+    std::string reportPath;
+    std::string locale;
+    std::string keyword;
+    std::vector<uint32_t> thresholds;
+    uint32_t silence = DEFAULT_SILENCE;
+
+    int option;
+    while ((option = ::getopt(argc, argv, "e:gc:m:d:t:l:k:s:o:h")) != -1) {
+        switch (option) {
+        case 'e':
+            engine = optarg;
+            break;
+        case 'g':
+            cascade = true;
+            break;
+        case 'c':
+            configPath = optarg;
+            break;
+        case 'm':
+            modelsPath = optarg;
+            break;
+        case 'd':
+            recordingsPath = optarg;
+            break;
+        case 't': {
+            std::stringstream list(optarg);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                thresholds.push_back(static_cast<uint32_t>(std::stoul(item)));
+            }
+            break;
+        }
+        case 'l':
+            locale = optarg;
+            break;
+        case 'k':
+            keyword = optarg;
+            break;
+        case 's':
+            silence = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'o':
+            reportPath = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((modelsPath.empty() == true) || (recordingsPath.empty() == true)
+        || ((configPath.empty() == true) && (Plugin::KeywordDetector::Configuration(engine).empty() == false))) {
+        Usage(argv[0]);
+        return 1;
+    }
+    if (Plugin::KeywordDetector::IsAvailable(engine) == false) {
+        fprintf(stderr, "Keyword detection engine %s is not compiled in\n", engine.c_str());
+        return 1;
+    }
+    if (thresholds.empty() == true) {
+        thresholds.push_back(200);
+    }
+
+    if (configPath.empty() == false) {
+        auto config = std::make_shared<std::ifstream>(configPath);
+        if ((config->good() == false) || (utils::configuration::ConfigurationNode::initialize({ config }) == false)) {
+            fprintf(stderr, "Failed to load the SDK configuration %s\n", configPath.c_str());
+            return 1;
+        }
+    }
+
+    const std::vector<Recording> recordings = LoadAll(recordingsPath);
+    if (recordings.empty() == true) {
+        fprintf(stderr, "No recordings found in %s\n", recordingsPath.c_str());
+        return 1;
+    }
+
+    Report report;
+    uint32_t keywords = 0;
+    uint64_t samples = 0;
+    for (const Recording& recording : recordings) {
+        keywords += static_cast<uint32_t>(recording.keywords.size());
+        samples += recording.samples.size();
+    }
+    report.Engine = engine;
+    report.Cascade = cascade;
+    report.Locale = locale;
+    report.Keyword = keyword;
+    report.Recordings = static_cast<uint32_t>(recordings.size());
+    report.Keywords = keywords;
+    report.Audio = static_cast<uint32_t>(samples / SAMPLES_PER_MILLISECOND);
+
+    int result = 0;
+    for (const uint32_t threshold : thresholds) {
+        ThresholdReport& entry = report.Thresholds.Add();
+        if (Run(recordings, engine, cascade, modelsPath, locale, keyword, threshold, entry) == false) {
+            fprintf(stderr, "Failed to run the detector at threshold %u\n", threshold);
+            result = 1;
+            break;
+        }
+    }
+
+    if ((result == 0) && (silence > 0)) {
+        Recording quiet;
+        quiet.name = "silence";
+        quiet.samples.assign(static_cast<size_t>(silence) * 1000 * SAMPLES_PER_MILLISECOND, 0);
+        if (Run({ quiet }, engine, cascade, modelsPath, locale, keyword, thresholds.front(), report.Silence) == false) {
+            fprintf(stderr, "Failed to run the detector on silence\n");
+            result = 1;
+        }
+    }
+
+    string output;
+    report.ToString(output);
+    if (reportPath.empty() == true) {
+        printf("%s\n", output.c_str());
+    } else {
+        std::ofstream file(reportPath);
+        file << output << std::endl;
+    }
+
+    utils::configuration::ConfigurationNode::uninitialize();
+    Core::Singleton::Dispose();
+
+    return result;
+}
@@ -0,0 +1,363 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Microbenchmark of the AVS SDK log sink.
+ *
+ * Logs the same lines from a number of threads, like the SDK executors do, once through the
+ * synchronous path ThunderLogger::emit used to take and once through the LogRing it uses now.
+ * The synchronous path builds a std::stringstream and a std::string per line, formats it the way
+ * the AVSSDK trace category does and writes it to the trace output under its lock. The ring path
+ * copies the line into the ring; a background thread formats and writes it.
+ *
+ * The trace output is a counter of the bytes written, so the report, in JSON, shows the cost on
+ * the logging thread only: the average and 99th percentile time per line, and the lines dropped.
+ * Back to back lines are a worst case for the ring; an interval between the lines of a thread
+ * gives the background thread the time it would have when the SDK logs at DEBUG levels.
+ */
+
+#include "Module.h"
+
+#include "LogRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+using namespace WPEFramework;
+
+namespace {
+
+    constexpr uint32_t DEFAULT_THREADS = 4;
+    constexpr uint32_t DEFAULT_LINES = 100000;
+    constexpr uint32_t DEFAULT_LENGTH = 160;
+    constexpr uint32_t DEFAULT_INTERVAL = 0;
+    constexpr size_t RING_RECORDS = 512;
+
+    // Stands in for the Thunder trace output: serialised, and the text has to be read
+    class Output {
+    public:
+        Output(const Output&) = delete;
+        Output& operator=(const Output&) = delete;
+
+        Output()
+            : _lock()
+            , _bytes(0)
+        {
+        }
+        ~Output() = default;
+
+    public:
+        void Write(const std::string& text)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _bytes += text.length();
+        }
+
+        uint64_t Bytes() const
+        {
+            return (_bytes);
+        }
+
+    private:
+        std::mutex _lock;
+        uint64_t _bytes;
+    };
+
+    // What the AVSSDK trace category does with its formatter
+    std::string Format(const char formatter[], ...)
+    {
+        va_list ap;
+        va_start(ap, formatter);
+        char buffer[1024];
+        const int length = ::vsnprintf(buffer, sizeof(buffer), formatter, ap);
+        va_end(ap);
+        return (std::string(buffer, std::max(0, std::min(length, static_cast<int>(sizeof(buffer) - 1)))));
+    }
+
+    class ModeReport : public Core::JSON::Container {
+    public:
+        ModeReport(const ModeReport& copy)
+            : Core::JSON::Container()
+            , Mode(copy.Mode)
+            , Lines(copy.Lines)
+            , Dropped(copy.Dropped)
+            , Average(copy.Average)
+            , Percentile99(copy.Percentile99)
+            , Duration(copy.Duration)
+        {
+            Init();
+        }
+
+        ModeReport()
+            : Core::JSON::Container()
+            , Mode()
+            , Lines()
+            , Dropped()
+            , Average()
+            , Percentile99()
+            , Duration()
+        {
+            Init();
+        }
+
+        ~ModeReport() override = default;
+
+    private:
+        void Init()
+        {
+            Add(_T("mode"), &Mode);
+            Add(_T("lines"), &Lines);
+            Add(_T("dropped"), &Dropped);
+            Add(_T("average"), &Average);
+            Add(_T("percentile99"), &Percentile99);
+            Add(_T("duration"), &Duration);
+        }
+
+    public:
+        Core::JSON::String Mode;
+        Core::JSON::DecUInt64 Lines;
+        Core::JSON::DecUInt64 Dropped;
+        // Nanoseconds per line on the logging thread
+        Core::JSON::DecUInt32 Average;
+        Core::JSON::DecUInt32 Percentile99;
+        // Milliseconds until all threads logged all their lines
+        Core::JSON::DecUInt32 Duration;
+    };
+
+    class Report : public Core::JSON::Container {
+    public:
+        Report(const Report&) = delete;
+        Report& operator=(const Report&) = delete;
+
+        Report()
+            : Core::JSON::Container()
+            , Threads()
+            , Length()
+            , Modes()
+        {
+            Add(_T("threads"), &Threads);
+            Add(_T("length"), &Length);
+            Add(_T("modes"), &Modes);
+        }
+
+        ~Report() override = default;
+
+    public:
+        Core::JSON::DecUInt32 Threads;
+        Core::JSON::DecUInt32 Length;
+        Core::JSON::ArrayType<ModeReport> Modes;
+    };
+
+    using Emit = std::function<void(const char moniker[], const char text[])>;
+
+    struct Load {
+        uint32_t threads;
+        uint32_t lines;
+        std::chrono::microseconds interval;
+        std::string text;
+    };
+
+    // Runs emit for the lines on each of the threads, returns the time each call took in nanoseconds
+    std::vector<uint32_t> Run(const Emit& emit, const Load& load, uint64_t& duration)
+    {
+        std::vector<std::vector<uint32_t>> timings(load.threads);
+        std::vector<std::thread> loggers;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t index = 0; index < load.threads; index++) {
+            loggers.emplace_back([&emit, &timings, &load, index]() {
+                char moniker[8];
+                ::snprintf(moniker, sizeof(moniker), "%06x", index);
+                std::vector<uint32_t>& timing = timings[index];
+                timing.reserve(load.lines);
+                for (uint32_t line = 0; line < load.lines; line++) {
+                    const auto before = std::chrono::steady_clock::now();
+                    emit(moniker, load.text.c_str());
+                    timing.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count()));
+                    if (load.interval.count() > 0) {
+                        std::this_thread::sleep_for(load.interval);
+                    }
+                }
+            });
+        }
+        for (std::thread& logger : loggers) {
+            logger.join();
+        }
+        duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<uint32_t> all;
+        for (const std::vector<uint32_t>& timing : timings) {
+            all.insert(all.end(), timing.begin(), timing.end());
+        }
+        return (all);
+    }
+
+    void Summarise(std::vector<uint32_t>& timings, const uint64_t duration, ModeReport& report)
+    {
+        uint64_t sum = 0;
+        for (const uint32_t timing : timings) {
+            sum += timing;
+        }
+        std::sort(timings.begin(), timings.end());
+
+        report.Lines = timings.size();
+        report.Average = (timings.empty() == false) ? static_cast<uint32_t>(sum / timings.size()) : 0;
+        report.Percentile99 = (timings.empty() == false) ? timings[(timings.size() * 99) / 100] : 0;
+        report.Duration = static_cast<uint32_t>(duration);
+    }
+
+    void Synchronous(const Load& load, ModeReport& report)
+    {
+        Output output;
+        const Emit emit = [&output](const char moniker[], const char text[]) {
+            std::stringstream ss;
+            ss << "[" << moniker << "] " << 'I' << " " << text;
+            output.Write(Format(ss.str().c_str()));
+        };
+
+        uint64_t duration = 0;
+        std::vector<uint32_t> timings = Run(emit, load, duration);
+        report.Mode = _T("synchronous");
+        report.Dropped = 0;
+        Summarise(timings, duration, report);
+    }
+
+    void Ring(const Load& load, ModeReport& report)
+    {
+        Output output;
+        Plugin::LogRing ring(RING_RECORDS);
+        std::atomic<bool> running(true);
+
+        std::thread dispatcher([&ring, &output, &running]() {
+            Plugin::LogRing::Record record;
+            while ((running == true) || (ring.IsEmpty() == false)) {
+                if (ring.Pop(record) == true) {
+                    output.Write(Format("[%s] %c %s", record.moniker, record.level, record.text));
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        const Emit emit = [&ring](const char moniker[], const char text[]) {
+            ring.Push(0, 0, 'I', moniker, text);
+        };
+
+        uint64_t duration = 0;
+        std::vector<uint32_t> timings = Run(emit, load, duration);
+        running = false;
+        dispatcher.join();
+
+        report.Mode = _T("ring");
+        report.Dropped = ring.Counters().droppedRecords;
+        Summarise(timings, duration, report);
+    }
+
+    void Usage(const char* name)
+    {
+        fprintf(stderr,
+            "Usage: %s [-t <threads>] [-n <lines>] [-s <length>] [-i <interval>] [-o <report>]\n"
+            "  -t  Logging threads, %u when not given\n"
+            "  -n  Lines logged per thread, %u when not given\n"
+            "  -s  Characters per line, %u when not given\n"
+            "  -i  Microseconds between the lines of a thread, %u when not given\n"
+            "  -o  File to write the report to, stdout when not given\n",
+            name, DEFAULT_THREADS, DEFAULT_LINES, DEFAULT_LENGTH, DEFAULT_INTERVAL);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Load load;
+    load.threads = DEFAULT_THREADS;
+    load.lines = DEFAULT_LINES;
+    load.interval = std::chrono::microseconds(DEFAULT_INTERVAL);
+    uint32_t length = DEFAULT_LENGTH;
+    std::string reportPath;
+
+    int option;
+    while ((option = ::getopt(argc, argv, "t:n:s:i:o:h")) != -1) {
+        switch (option) {
+        case 't':
+            load.threads = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'n':
+            load.lines = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 's':
+            length = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'i':
+            load.interval = std::chrono::microseconds(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'o':
+            reportPath = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((load.threads == 0) || (load.lines == 0)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    // Looks like an SDK line: a tag, an event and a few key/value pairs
+    load.text = "AudioInputProcessor:executeOnDialogUXStateChanged:state=THINKING";
+    while (load.text.length() < length) {
+        load.text += ",key=value";
+    }
+    load.text.resize(length);
+
+    Report report;
+    report.Threads = load.threads;
+    report.Length = length;
+    Synchronous(load, report.Modes.Add());
+    Ring(load, report.Modes.Add());
+
+    string output;
+    report.ToString(output);
+    if (reportPath.empty() == true) {
+        printf("%s\n", output.c_str());
+    } else {
+        std::ofstream file(reportPath);
+        file << output << std::endl;
+    }
+
+    Core::Singleton::Dispose();
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Turns a flight recorder dump of the AVS SDK logs back into text.
+ *
+ * Runs on the host, it needs neither Thunder nor the AVS SDK. Lines are printed from the oldest
+ * to the newest as "<UTC time> [<thread moniker>] <level> <text>", like the traces of the plugin.
+ */
+
+#include "FlightRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+    class Reader {
+    public:
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        explicit Reader(const std::vector<uint8_t>& data)
+            : _data(data)
+            , _offset(0)
+            , _isValid(true)
+        {
+        }
+        ~Reader() = default;
+
+    public:
+        bool IsValid() const
+        {
+            return (_isValid);
+        }
+        size_t Offset() const
+        {
+            return (_offset);
+        }
+        const uint8_t* Take(const size_t length)
+        {
+            const uint8_t* data = nullptr;
+            if ((_isValid == true) && ((_data.size() - _offset) >= length)) {
+                data = &_data[_offset];
+                _offset += length;
+            } else {
+                _isValid = false;
+            }
+            return (data);
+        }
+        uint16_t Get16()
+        {
+            const uint8_t* data = Take(2);
+            return ((data != nullptr) ? Plugin::FlightRecorder::Get16(data) : 0);
+        }
+        uint32_t Get32()
+        {
+            const uint8_t* data = Take(4);
+            return ((data != nullptr) ? Plugin::FlightRecorder::Get32(data) : 0);
+        }
+        uint64_t Get64()
+        {
+            const uint8_t* data = Take(8);
+            return ((data != nullptr) ? Plugin::FlightRecorder::Get64(data) : 0);
+        }
+        std::string GetString()
+        {
+            const uint16_t length = Get16();
+            const uint8_t* data = Take(length);
+            return ((data != nullptr) ? std::string(reinterpret_cast<const char*>(data), length) : std::string());
+        }
+
+    private:
+        const std::vector<uint8_t>& _data;
+        size_t _offset;
+        bool _isValid;
+    };
+
+    std::vector<std::string> Dictionary(Reader& reader)
+    {
+        std::vector<std::string> entries(reader.Get16());
+        for (std::string& entry : entries) {
+            entry = reader.GetString();
+        }
+        return (entries);
+    }
+
+    std::string Time(const uint64_t microseconds)
+    {
+        const time_t seconds = static_cast<time_t>(microseconds / 1000000);
+        struct tm utc;
+        ::gmtime_r(&seconds, &utc);
+
+        char text[40];
+        const size_t length = ::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &utc);
+        ::snprintf(&text[length], sizeof(text) - length, ".%06uZ", static_cast<uint32_t>(microseconds % 1000000));
+        return (text);
+    }
+
+    const std::string& Entry(const std::vector<std::string>& entries, const uint16_t id)
+    {
+        static const std::string none;
+        return ((id < entries.size()) ? entries[id] : none);
+    }
+
+    bool Decode(const std::vector<uint8_t>& data, FILE* output)
+    {
+        Reader reader(data);
+
+        const uint8_t* magic = reader.Take(sizeof(Plugin::FlightRecorder::MAGIC));
+        if ((magic == nullptr) || (::memcmp(magic, Plugin::FlightRecorder::MAGIC, sizeof(Plugin::FlightRecorder::MAGIC)) != 0)) {
+            fprintf(stderr, "Not a flight recorder dump\n");
+            return false;
+        }
+        const uint16_t version = reader.Get16();
+        if (version != Plugin::FlightRecorder::VERSION) {
+            fprintf(stderr, "Unsupported flight recorder version %u\n", version);
+            return false;
+        }
+        const uint64_t dumped = reader.Get64();
+        const std::vector<std::string> monikers = Dictionary(reader);
+        const std::vector<std::string> formats = Dictionary(reader);
+        const uint32_t size = reader.Get32();
+        if (reader.IsValid() == false) {
+            fprintf(stderr, "The flight recorder dump is cut off in its header\n");
+            return false;
+        }
+
+        fprintf(output, "# Flight recorder dumped at %s, %u bytes of records\n", Time(dumped).c_str(), size);
+
+        const size_t end = reader.Offset() + size;
+        uint32_t records = 0;
+        while ((reader.IsValid() == true) && (reader.Offset() < end)) {
+            const uint16_t recordSize = reader.Get16();
+            const uint8_t* header = reader.Take(Plugin::FlightRecorder::RECORD_HEADER_SIZE - 2);
+            if ((header == nullptr) || (recordSize < Plugin::FlightRecorder::RECORD_HEADER_SIZE)) {
+                break;
+            }
+            const char level = static_cast<char>(header[0]);
+            const bool isTruncated = ((header[1] & Plugin::FlightRecorder::FLAG_TRUNCATED) != 0);
+            const uint16_t moniker = Plugin::FlightRecorder::Get16(&header[2]);
+            const uint16_t format = Plugin::FlightRecorder::Get16(&header[4]);
+            const uint64_t time = Plugin::FlightRecorder::Get64(&header[6]);
+            const size_t length = recordSize - Plugin::FlightRecorder::RECORD_HEADER_SIZE;
+            const uint8_t* arguments = reader.Take(length);
+            if (arguments == nullptr) {
+                break;
+            }
+
+            fprintf(output, "%s [%s] %c %s%.*s%s\n", Time(time).c_str(), Entry(monikers, moniker).c_str(), level,
+                Entry(formats, format).c_str(), static_cast<int>(length), reinterpret_cast<const char*>(arguments),
+                (isTruncated == true) ? "..." : "");
+            records++;
+        }
+
+        if ((reader.IsValid() == false) || (reader.Offset() != end)) {
+            fprintf(stderr, "The flight recorder dump is cut off after %u records\n", records);
+            return false;
+        }
+
+        return true;
+    }
+
+    void Usage(const char* name)
+    {
+        fprintf(stderr,
+            "Usage: %s [-o <text>] <dump>\n"
+            "  -o  File to write the text to, stdout when not given\n",
+            name);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string outputPath;
+
+    int option;
+    while ((option = ::getopt(argc, argv, "o:h")) != -1) {
+        switch (option) {
+        case 'o':
+            outputPath = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (optind != (argc - 1)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    std::ifstream file(argv[optind], std::ios::binary);
+    if (file.good() == false) {
+        fprintf(stderr, "Failed to open %s\n", argv[optind]);
+        return 1;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    FILE* output = stdout;
+    if (outputPath.empty() == false) {
+        output = ::fopen(outputPath.c_str(), "w");
+        if (output == nullptr) {
+            fprintf(stderr, "Failed to create %s\n", outputPath.c_str());
+            return 1;
+        }
+    }
+
+    const bool result = Decode(data, output);
+
+    if (output != stdout) {
+        ::fclose(output);
+    }
+
+    return ((result == true) ? 0 : 1);
+}
@@ -0,0 +1,489 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Latency benchmark of the posts for VoiceToApps.
+ *
+ * Posts bursts of JSON documents, like the template cards and Speak directives of a few
+ * utterances, to an HTTP endpoint. Once the way VoiceToApps posts them, one after the other,
+ * each on a connection of its own, and once through the HttpDispatcher with its kept-alive
+ * connections. Unless an endpoint is given the posts go to a stand-in server in this process,
+ * which can delay the first response on each connection to act like a remote server that
+ * costs a handshake to connect to.
+ *
+ * The report, in JSON, shows the latency from the start of the burst to the response of a post
+ * and the connections the server accepted.
+ */
+
+#include "Module.h"
+
+#include "HttpDispatcher.h"
+
+#include <curl/curl.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+using namespace WPEFramework;
+
+namespace {
+
+    constexpr uint32_t DEFAULT_BURSTS = 20;
+    constexpr uint32_t DEFAULT_BURST = 4;
+    constexpr uint32_t DEFAULT_SIZE = 512;
+    constexpr uint32_t DEFAULT_SETUP = 20;
+    constexpr uint32_t DEFAULT_CONNECTIONS = 2;
+
+    // Keep-alive HTTP/1.1 server answering every request with an empty 200
+    class StandInServer {
+    public:
+        StandInServer(const StandInServer&) = delete;
+        StandInServer& operator=(const StandInServer&) = delete;
+
+        StandInServer(const std::chrono::milliseconds setup, const std::chrono::milliseconds delay)
+            : _setup(setup)
+            , _delay(delay)
+            , _socket(-1)
+            , _port(0)
+            , _connections(0)
+            , _lock()
+            , _clients()
+            , _threads()
+            , _acceptor()
+        {
+        }
+
+        ~StandInServer()
+        {
+            if (_socket != -1) {
+                ::shutdown(_socket, SHUT_RDWR);
+                ::close(_socket);
+                _acceptor.join();
+            }
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                for (const int client : _clients) {
+                    ::shutdown(client, SHUT_RDWR);
+                }
+            }
+            for (std::thread& thread : _threads) {
+                thread.join();
+            }
+        }
+
+    public:
+        bool Start()
+        {
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = 0;
+            socklen_t length = sizeof(address);
+
+            _socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if ((_socket == -1)
+                || (::bind(_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+                || (::listen(_socket, 16) != 0)
+                || (::getsockname(_socket, reinterpret_cast<sockaddr*>(&address), &length) != 0)) {
+                return (false);
+            }
+
+            _port = ntohs(address.sin_port);
+            _acceptor = std::thread(&StandInServer::Accept, this);
+            return (true);
+        }
+
+        uint16_t Port() const
+        {
+            return (_port);
+        }
+
+        uint32_t Connections() const
+        {
+            return (_connections.load());
+        }
+
+    private:
+        void Accept()
+        {
+            int client;
+            while ((client = ::accept4(_socket, nullptr, nullptr, SOCK_CLOEXEC)) != -1) {
+                _connections++;
+                std::lock_guard<std::mutex> lock(_lock);
+                _clients.push_back(client);
+                _threads.emplace_back(&StandInServer::Serve, this, client);
+            }
+        }
+
+        void Serve(const int client)
+        {
+            static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+            static const char RESPONSE[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+
+            std::string received;
+            bool isFirst = true;
+            char buffer[4096];
+            ssize_t size;
+            while ((size = ::recv(client, buffer, sizeof(buffer), 0)) > 0) {
+                received.append(buffer, size);
+
+                size_t end;
+                while ((end = received.find("\r\n\r\n")) != std::string::npos) {
+                    std::string header(received, 0, end);
+                    std::transform(header.begin(), header.end(), header.begin(), ::tolower);
+
+                    const size_t field = header.find("content-length:");
+                    const size_t body = (field != std::string::npos) ? std::strtoul(&header[field + 15], nullptr, 10) : 0;
+                    if ((received.size() - end - 4) < body) {
+                        if ((header.find("expect: 100-continue") != std::string::npos) && (received.size() == (end + 4))) {
+                            ::send(client, CONTINUE, sizeof(CONTINUE) - 1, MSG_NOSIGNAL);
+                        }
+                        break;
+                    }
+                    received.erase(0, end + 4 + body);
+
+                    std::this_thread::sleep_for((isFirst == true) ? (_setup + _delay) : _delay);
+                    isFirst = false;
+                    ::send(client, RESPONSE, sizeof(RESPONSE) - 1, MSG_NOSIGNAL);
+                }
+            }
+            ::close(client);
+        }
+
+    private:
+        const std::chrono::milliseconds _setup;
+        const std::chrono::milliseconds _delay;
+        int _socket;
+        uint16_t _port;
+        std::atomic<uint32_t> _connections;
+        std::mutex _lock;
+        std::vector<int> _clients;
+        std::vector<std::thread> _threads;
+        std::thread _acceptor;
+    };
+
+    class ModeReport : public Core::JSON::Container {
+    public:
+        ModeReport(const ModeReport& copy)
+            : Core::JSON::Container()
+            , Mode(copy.Mode)
+            , Sent(copy.Sent)
+            , Failed(copy.Failed)
+            , Latency(copy.Latency)
+            , MaxLatency(copy.MaxLatency)
+            , Connections(copy.Connections)
+            , Duration(copy.Duration)
+        {
+            Init();
+        }
+
+        ModeReport()
+            : Core::JSON::Container()
+            , Mode()
+            , Sent()
+            , Failed()
+            , Latency()
+            , MaxLatency()
+            , Connections()
+            , Duration()
+        {
+            Init();
+        }
+
+        ~ModeReport() override = default;
+
+    private:
+        void Init()
+        {
+            Add(_T("mode"), &Mode);
+            Add(_T("sent"), &Sent);
+            Add(_T("failed"), &Failed);
+            Add(_T("latency"), &Latency);
+            Add(_T("maxlatency"), &MaxLatency);
+            Add(_T("connections"), &Connections);
+            Add(_T("duration"), &Duration);
+        }
+
+    public:
+        Core::JSON::String Mode;
+        Core::JSON::DecUInt32 Sent;
+        Core::JSON::DecUInt32 Failed;
+        // Microseconds from the start of the burst to the response, average and longest
+        Core::JSON::DecUInt64 Latency;
+        Core::JSON::DecUInt64 MaxLatency;
+        // Accepted by the stand-in server, 0 for an endpoint given
+        Core::JSON::DecUInt32 Connections;
+        // Milliseconds for all bursts
+        Core::JSON::DecUInt64 Duration;
+    };
+
+    class Report : public Core::JSON::Container {
+    public:
+        Report(const Report&) = delete;
+        Report& operator=(const Report&) = delete;
+
+        Report()
+            : Core::JSON::Container()
+            , Endpoint()
+            , Bursts()
+            , Burst()
+            , Size()
+            , Modes()
+        {
+            Add(_T("endpoint"), &Endpoint);
+            Add(_T("bursts"), &Bursts);
+            Add(_T("burst"), &Burst);
+            Add(_T("size"), &Size);
+            Add(_T("modes"), &Modes);
+        }
+
+        ~Report() override = default;
+
+    public:
+        Core::JSON::String Endpoint;
+        Core::JSON::DecUInt32 Bursts;
+        Core::JSON::DecUInt32 Burst;
+        Core::JSON::DecUInt32 Size;
+        Core::JSON::ArrayType<ModeReport> Modes;
+    };
+
+    size_t Discard(char*, size_t size, size_t count, void*)
+    {
+        return (size * count);
+    }
+
+    // A template card like document of the given size, distinct per number
+    std::string Document(const uint32_t number, const uint32_t size)
+    {
+        std::string document("{\"directive\":{\"header\":{\"namespace\":\"TemplateRuntime\",\"name\":\"RenderTemplate\",\"messageId\":\"" + std::to_string(number) + "\"},\"payload\":\"");
+        document.append((size > (document.size() + 4)) ? (size - document.size() - 4) : 0, 'x');
+        document.append("\"}}");
+        return (document);
+    }
+
+    // As VoiceToApps does: one post after the other, each with a connection of its own
+    void RunFresh(const std::string& endpoint, const uint32_t bursts, const uint32_t burst, const uint32_t size, const std::chrono::milliseconds timeout, ModeReport& report)
+    {
+        uint32_t sent = 0;
+        uint32_t failed = 0;
+        uint64_t totalLatency = 0;
+        uint64_t maxLatency = 0;
+
+        curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t round = 0; round < bursts; round++) {
+            const auto posted = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < burst; index++) {
+                const std::string document(Document((round * burst) + index, size));
+
+                CURL* easy = curl_easy_init();
+                curl_easy_setopt(easy, CURLOPT_URL, endpoint.c_str());
+                curl_easy_setopt(easy, CURLOPT_HTTPHEADER, headers);
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(document.size()));
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDS, document.c_str());
+                curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+                curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+                curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, Discard);
+                const CURLcode result = curl_easy_perform(easy);
+                long status = 0;
+                curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+                curl_easy_cleanup(easy);
+
+                if ((result == CURLE_OK) && (status < 400)) {
+                    const uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - posted).count();
+                    totalLatency += latency;
+                    maxLatency = std::max(maxLatency, latency);
+                    sent++;
+                } else {
+                    failed++;
+                }
+            }
+        }
+        const uint64_t duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        curl_slist_free_all(headers);
+
+        report.Mode = _T("fresh");
+        report.Sent = sent;
+        report.Failed = failed;
+        report.Latency = (sent > 0) ? (totalLatency / sent) : 0;
+        report.MaxLatency = maxLatency;
+        report.Duration = duration;
+    }
+
+    void RunDispatcher(const std::string& endpoint, const uint32_t bursts, const uint32_t burst, const uint32_t size, const std::chrono::milliseconds timeout, const uint32_t connections, ModeReport& report)
+    {
+        Plugin::HttpDispatcher::Settings settings;
+        settings.endpoint = endpoint;
+        settings.connections = connections;
+        settings.timeout = timeout;
+        settings.queue = std::max(settings.queue, burst);
+
+        Plugin::HttpDispatcher dispatcher(settings);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t round = 0; (round < bursts) && (dispatcher.IsValid() == true); round++) {
+            for (uint32_t index = 0; index < burst; index++) {
+                dispatcher.Post(Document((round * burst) + index, size));
+            }
+            dispatcher.Flush(timeout * (settings.retries + 1) * burst);
+        }
+        const uint64_t duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        const Plugin::HttpDispatcher::Statistics statistics = dispatcher.Counters();
+
+        report.Mode = _T("dispatcher");
+        report.Sent = static_cast<uint32_t>(statistics.sent);
+        report.Failed = static_cast<uint32_t>(statistics.failed + statistics.dropped);
+        report.Latency = statistics.averageLatency;
+        report.MaxLatency = statistics.maxLatency;
+        report.Duration = duration;
+    }
+
+    void Usage(const char* name)
+    {
+        fprintf(stderr,
+            "Usage: %s [-u <endpoint>] [-n <bursts>] [-b <burst>] [-s <size>] [-c <connections>] [-a <setup>] [-d <delay>] [-o <report>]\n"
+            "  -u  URL to post to, the stand-in server when not given\n"
+            "  -n  Bursts of posts, %u when not given\n"
+            "  -b  Posts per burst, %u when not given\n"
+            "  -s  Bytes per post, %u when not given\n"
+            "  -c  Connections of the dispatcher, %u when not given\n"
+            "  -a  Milliseconds the stand-in server takes to answer first on a connection, %u when not given\n"
+            "  -d  Milliseconds the stand-in server takes to answer, 0 when not given\n"
+            "  -o  File to write the report to, stdout when not given\n",
+            name, DEFAULT_BURSTS, DEFAULT_BURST, DEFAULT_SIZE, DEFAULT_CONNECTIONS, DEFAULT_SETUP);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string endpoint;
+    uint32_t bursts = DEFAULT_BURSTS;
+    uint32_t burst = DEFAULT_BURST;
+    uint32_t size = DEFAULT_SIZE;
+    uint32_t connections = DEFAULT_CONNECTIONS;
+    uint32_t setup = DEFAULT_SETUP;
+    uint32_t delay = 0;
+    std::string reportPath;
+
+    int option;
+    while ((option = ::getopt(argc, argv, "u:n:b:s:c:a:d:o:h")) != -1) {
+        switch (option) {
+        case 'u':
+            endpoint = optarg;
+            break;
+        case 'n':
+            bursts = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'b':
+            burst = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 's':
+            size = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'c':
+            connections = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'a':
+            setup = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'd':
+            delay = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'o':
+            reportPath = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((bursts == 0) || (burst == 0) || (connections == 0)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    {
+        const std::chrono::milliseconds timeout(2000 + setup + (delay * burst));
+
+        Report report;
+        report.Bursts = bursts;
+        report.Burst = burst;
+        report.Size = size;
+
+        std::unique_ptr<StandInServer> server;
+        if (endpoint.empty() == true) {
+            server.reset(new StandInServer(std::chrono::milliseconds(setup), std::chrono::milliseconds(delay)));
+            if (server->Start() == false) {
+                fprintf(stderr, "Failed to start the stand-in server\n");
+                return 1;
+            }
+            endpoint = "http://127.0.0.1:" + std::to_string(server->Port()) + "/vta";
+        }
+        report.Endpoint = endpoint;
+
+        uint32_t accepted = 0;
+
+        ModeReport& fresh = report.Modes.Add();
+        RunFresh(endpoint, bursts, burst, size, timeout, fresh);
+        if (server) {
+            fresh.Connections = server->Connections() - accepted;
+            accepted = server->Connections();
+        }
+
+        ModeReport& dispatched = report.Modes.Add();
+        RunDispatcher(endpoint, bursts, burst, size, timeout, connections, dispatched);
+        if (server) {
+            dispatched.Connections = server->Connections() - accepted;
+        }
+
+        string output;
+        report.ToString(output);
+        if (reportPath.empty() == true) {
+            printf("%s\n", output.c_str());
+        } else {
+            std::ofstream file(reportPath);
+            file << output << std::endl;
+        }
+    }
+
+    curl_global_cleanup();
+    Core::Singleton::Dispose();
+
+    return 0;
+}
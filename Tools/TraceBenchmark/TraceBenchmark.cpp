@@ -0,0 +1,275 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Microbenchmark of the trace categories.
+ *
+ * Creates the same trace over and over, once with a category keeping its text in a std::string,
+ * as AVSSDK and AVSClient used to, and once with the inline buffer of the TraceCategory they use
+ * now. Each is run with the category enabled and disabled in the trace controller. The category
+ * is created directly, not through TRACE(), so a disabled run shows what the category itself costs.
+ *
+ * The report, in JSON, shows the average time and the heap allocations per trace.
+ */
+
+#include "Module.h"
+
+#include "TraceCategories.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#include <getopt.h>
+
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+using namespace WPEFramework;
+
+namespace {
+
+    constexpr uint32_t DEFAULT_TRACES = 1000000;
+    constexpr uint32_t DEFAULT_LENGTH = 64;
+
+    std::atomic<uint64_t> allocations(0);
+
+    // The trace categories as they were: the text is formatted into a std::string
+    class StringCategory {
+    public:
+        StringCategory() = delete;
+        StringCategory(const StringCategory& a_Copy) = delete;
+        StringCategory& operator=(const StringCategory& a_RHS) = delete;
+        ~StringCategory() = default;
+
+        StringCategory(const TCHAR formatter[], ...)
+        {
+            va_list ap;
+            va_start(ap, formatter);
+            Trace::Format(_text, formatter, ap);
+            va_end(ap);
+        }
+
+        inline const char* Data() const
+        {
+            return (_text.c_str());
+        }
+
+        inline uint16_t Length() const
+        {
+            return (static_cast<uint16_t>(_text.length()));
+        }
+
+    private:
+        std::string _text;
+    };
+
+    class InlineCategory : public Plugin::TraceCategory<InlineCategory, 256> {
+    public:
+        InlineCategory() = delete;
+        ~InlineCategory() = default;
+
+        InlineCategory(const TCHAR formatter[], ...)
+        {
+            va_list ap;
+            va_start(ap, formatter);
+            Format(formatter, ap);
+            va_end(ap);
+        }
+    };
+
+    class ModeReport : public Core::JSON::Container {
+    public:
+        ModeReport(const ModeReport& copy)
+            : Core::JSON::Container()
+            , Category(copy.Category)
+            , Enabled(copy.Enabled)
+            , Average(copy.Average)
+            , Allocations(copy.Allocations)
+            , Duration(copy.Duration)
+        {
+            Init();
+        }
+
+        ModeReport()
+            : Core::JSON::Container()
+            , Category()
+            , Enabled()
+            , Average()
+            , Allocations()
+            , Duration()
+        {
+            Init();
+        }
+
+        ~ModeReport() override = default;
+
+    private:
+        void Init()
+        {
+            Add(_T("category"), &Category);
+            Add(_T("enabled"), &Enabled);
+            Add(_T("average"), &Average);
+            Add(_T("allocations"), &Allocations);
+            Add(_T("duration"), &Duration);
+        }
+
+    public:
+        Core::JSON::String Category;
+        Core::JSON::Boolean Enabled;
+        // Nanoseconds per trace
+        Core::JSON::DecUInt32 Average;
+        // Heap allocations per 1000 traces
+        Core::JSON::DecUInt32 Allocations;
+        // Microseconds for all traces
+        Core::JSON::DecUInt64 Duration;
+    };
+
+    class Report : public Core::JSON::Container {
+    public:
+        Report(const Report&) = delete;
+        Report& operator=(const Report&) = delete;
+
+        Report()
+            : Core::JSON::Container()
+            , Traces()
+            , Length()
+            , Modes()
+        {
+            Add(_T("traces"), &Traces);
+            Add(_T("length"), &Length);
+            Add(_T("modes"), &Modes);
+        }
+
+        ~Report() override = default;
+
+    public:
+        Core::JSON::DecUInt32 Traces;
+        Core::JSON::DecUInt32 Length;
+        Core::JSON::ArrayType<ModeReport> Modes;
+    };
+
+    template <typename CATEGORY>
+    void Run(const char name[], const bool enabled, const uint32_t traces, const std::string& argument, ModeReport& report)
+    {
+        Trace::TraceType<CATEGORY, &Core::System::MODULE_NAME>::Enable(enabled);
+
+        // Read back, so the compiler can not leave the text out
+        volatile uint32_t length = 0;
+        const uint64_t allocated = allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t trace = 0; trace < traces; trace++) {
+            // Like a trace of the voice input path: a few numbers and a string
+            CATEGORY category(_T("Voice input of %u Hz, %u channels, %u bits from %s can not be converted, dropping it"), 16000, 1, trace, argument.c_str());
+            length = length + category.Length();
+        }
+        const uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        report.Category = name;
+        report.Enabled = enabled;
+        report.Average = static_cast<uint32_t>(duration / traces);
+        report.Allocations = static_cast<uint32_t>(((allocations.load() - allocated) * 1000) / traces);
+        report.Duration = duration / 1000;
+
+        Trace::TraceType<CATEGORY, &Core::System::MODULE_NAME>::Enable(true);
+    }
+
+    void Usage(const char* name)
+    {
+        fprintf(stderr,
+            "Usage: %s [-n <traces>] [-s <length>] [-o <report>]\n"
+            "  -n  Traces created per run, %u when not given\n"
+            "  -s  Characters of the string in the trace, %u when not given\n"
+            "  -o  File to write the report to, stdout when not given\n",
+            name, DEFAULT_TRACES, DEFAULT_LENGTH);
+    }
+
+} // namespace
+
+// Counts the heap allocations of the whole process, the runs are single threaded
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc((size > 0) ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return (memory);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t traces = DEFAULT_TRACES;
+    uint32_t length = DEFAULT_LENGTH;
+    std::string reportPath;
+
+    int option;
+    while ((option = ::getopt(argc, argv, "n:s:o:h")) != -1) {
+        switch (option) {
+        case 'n':
+            traces = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 's':
+            length = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'o':
+            reportPath = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (traces == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    const std::string argument(length, 'x');
+
+    Report report;
+    report.Traces = traces;
+    report.Length = length;
+    Run<StringCategory>(_T("string"), true, traces, argument, report.Modes.Add());
+    Run<StringCategory>(_T("string"), false, traces, argument, report.Modes.Add());
+    Run<InlineCategory>(_T("inline"), true, traces, argument, report.Modes.Add());
+    Run<InlineCategory>(_T("inline"), false, traces, argument, report.Modes.Add());
+
+    string output;
+    report.ToString(output);
+    if (reportPath.empty() == true) {
+        printf("%s\n", output.c_str());
+    } else {
+        std::ofstream file(reportPath);
+        file << output << std::endl;
+    }
+
+    Core::Singleton::Dispose();
+
+    return 0;
+}
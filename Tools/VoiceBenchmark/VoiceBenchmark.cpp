@@ -0,0 +1,441 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Microbenchmark of the Thunder voice input conversion.
+ *
+ * Runs a synthetic, speech-like signal through the AudioConverter at each common sample rate
+ * with one and two channels, converting to the 16 kHz mono of the shared data stream, and
+ * through each compiled in VoiceDecoder at the rates and channels it accepts. The input is
+ * handed over in packets of the given duration, like IVoiceHandler::Data() does, and the
+ * packets are encoded before the clock starts.
+ *
+ * The report, in JSON, shows the time each run takes per second of audio in microseconds.
+ */
+
+#include "Module.h"
+
+#include "AudioConverter.h"
+#include "VoiceDecoder.h"
+
+#if defined(VOICE_DECODER_OPUS)
+#include <opus/opus.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <getopt.h>
+
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+using namespace WPEFramework;
+
+namespace {
+
+    constexpr uint32_t DEFAULT_SECONDS = 60;
+    constexpr uint32_t DEFAULT_PACKET = 20;
+    constexpr uint32_t OUTPUT_RATE = 16000;
+    constexpr uint8_t MAX_CHANNELS = 2;
+    constexpr uint32_t RATES[] = { 8000, 11025, 12000, 16000, 22050, 24000, 32000, 44100, 48000 };
+    // Longest Opus frame, the decoder output is sized for it
+    constexpr uint32_t MAX_FRAME_MS = 120;
+
+    // Same tables as the decoder, for the encoder that makes its packets
+    constexpr int16_t IMA_STEP_SIZES[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+        19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+        130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+        337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+        5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+    constexpr int8_t IMA_INDEX_ADJUSTMENTS[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+    typedef std::vector<std::vector<uint8_t>> Packets;
+
+    class ConversionReport : public Core::JSON::Container {
+    public:
+        ConversionReport(const ConversionReport& copy)
+            : Core::JSON::Container()
+            , Rate(copy.Rate)
+            , Channels(copy.Channels)
+            , PassThrough(copy.PassThrough)
+            , Cost(copy.Cost)
+        {
+            Init();
+        }
+
+        ConversionReport()
+            : Core::JSON::Container()
+            , Rate()
+            , Channels()
+            , PassThrough()
+            , Cost()
+        {
+            Init();
+        }
+
+        ~ConversionReport() override = default;
+
+    private:
+        void Init()
+        {
+            Add(_T("rate"), &Rate);
+            Add(_T("channels"), &Channels);
+            Add(_T("passthrough"), &PassThrough);
+            Add(_T("cost"), &Cost);
+        }
+
+    public:
+        Core::JSON::DecUInt32 Rate;
+        Core::JSON::DecUInt8 Channels;
+        Core::JSON::Boolean PassThrough;
+        // Microseconds per second of audio
+        Core::JSON::DecUInt32 Cost;
+    };
+
+    class DecoderReport : public Core::JSON::Container {
+    public:
+        DecoderReport(const DecoderReport& copy)
+            : Core::JSON::Container()
+            , Codec(copy.Codec)
+            , Rate(copy.Rate)
+            , Channels(copy.Channels)
+            , Size(copy.Size)
+            , Cost(copy.Cost)
+        {
+            Init();
+        }
+
+        DecoderReport()
+            : Core::JSON::Container()
+            , Codec()
+            , Rate()
+            , Channels()
+            , Size()
+            , Cost()
+        {
+            Init();
+        }
+
+        ~DecoderReport() override = default;
+
+    private:
+        void Init()
+        {
+            Add(_T("codec"), &Codec);
+            Add(_T("rate"), &Rate);
+            Add(_T("channels"), &Channels);
+            Add(_T("size"), &Size);
+            Add(_T("cost"), &Cost);
+        }
+
+    public:
+        Core::JSON::String Codec;
+        Core::JSON::DecUInt32 Rate;
+        Core::JSON::DecUInt8 Channels;
+        // Average bytes per packet
+        Core::JSON::DecUInt32 Size;
+        // Microseconds per second of audio
+        Core::JSON::DecUInt32 Cost;
+    };
+
+    class Report : public Core::JSON::Container {
+    public:
+        Report(const Report&) = delete;
+        Report& operator=(const Report&) = delete;
+
+        Report()
+            : Core::JSON::Container()
+            , Seconds()
+            , Packet()
+            , Conversions()
+            , Decoders()
+        {
+            Add(_T("seconds"), &Seconds);
+            Add(_T("packet"), &Packet);
+            Add(_T("conversions"), &Conversions);
+            Add(_T("decoders"), &Decoders);
+        }
+
+        ~Report() override = default;
+
+    public:
+        Core::JSON::DecUInt32 Seconds;
+        // Milliseconds of audio per packet
+        Core::JSON::DecUInt32 Packet;
+        Core::JSON::ArrayType<ConversionReport> Conversions;
+        Core::JSON::ArrayType<DecoderReport> Decoders;
+    };
+
+    // One second of interleaved audio: a voice-like harmonic series gliding in pitch, with a
+    // little noise, each channel a bit delayed so that the down-mix is not a plain copy
+    void Synthesize(const uint32_t rate, const uint8_t channels, std::vector<int16_t>& samples)
+    {
+        const double pi = std::acos(-1.0);
+        samples.resize(rate * channels);
+
+        uint32_t noise = 12345;
+        for (uint32_t frame = 0; frame < rate; ++frame) {
+            for (uint8_t channel = 0; channel < channels; ++channel) {
+                const double time = static_cast<double>(frame + (channel * 7)) / rate;
+                const double pitch = 140.0 + (40.0 * std::sin(2.0 * pi * 3.0 * time));
+                double value = 0.0;
+                for (uint32_t harmonic = 1; harmonic <= 8; ++harmonic) {
+                    value += std::sin(2.0 * pi * pitch * harmonic * time) / harmonic;
+                }
+                noise = (noise * 1103515245) + 12345;
+                value = (value * 6000.0) + (static_cast<int32_t>((noise >> 16) & 0x3FF) - 512);
+                samples[(frame * channels) + channel] = static_cast<int16_t>(value);
+            }
+        }
+    }
+
+    // Blocks as ImaAdpcmDecoder takes them: the first sample and step index, then 4-bit codes
+    void EncodeImaAdpcm(const std::vector<int16_t>& samples, const uint32_t frames, Packets& packets)
+    {
+        int32_t index = 0;
+        const uint32_t codes = frames / 2;
+
+        for (size_t offset = 0; (offset + (codes * 2) + 1) <= samples.size(); offset += (codes * 2) + 1) {
+            std::vector<uint8_t> packet(4 + codes);
+            int32_t predictor = samples[offset];
+            packet[0] = static_cast<uint8_t>(predictor & 0xFF);
+            packet[1] = static_cast<uint8_t>((predictor >> 8) & 0xFF);
+            packet[2] = static_cast<uint8_t>(index);
+            packet[3] = 0;
+
+            for (uint32_t position = 0; position < (codes * 2); ++position) {
+                const int32_t step = IMA_STEP_SIZES[index];
+                int32_t difference = samples[offset + 1 + position] - predictor;
+                uint8_t code = 0;
+                if (difference < 0) {
+                    code = 0x8;
+                    difference = -difference;
+                }
+
+                int32_t delta = step >> 3;
+                if (difference >= step) {
+                    code |= 0x4;
+                    difference -= step;
+                    delta += step;
+                }
+                if (difference >= (step >> 1)) {
+                    code |= 0x2;
+                    difference -= (step >> 1);
+                    delta += (step >> 1);
+                }
+                if (difference >= (step >> 2)) {
+                    code |= 0x1;
+                    delta += (step >> 2);
+                }
+
+                predictor += ((code & 0x8) != 0) ? -delta : delta;
+                predictor = (predictor > 32767) ? 32767 : ((predictor < -32768) ? -32768 : predictor);
+                index += IMA_INDEX_ADJUSTMENTS[code & 0x7];
+                index = (index > 88) ? 88 : ((index < 0) ? 0 : index);
+
+                packet[4 + (position / 2)] |= ((position & 1) == 0) ? code : static_cast<uint8_t>(code << 4);
+            }
+            packets.push_back(std::move(packet));
+        }
+    }
+
+#if defined(VOICE_DECODER_OPUS)
+    void EncodeOpus(const std::vector<int16_t>& samples, const uint32_t rate, const uint8_t channels, const uint32_t frames, Packets& packets)
+    {
+        int error = OPUS_OK;
+        OpusEncoder* encoder = opus_encoder_create(static_cast<opus_int32>(rate), channels, OPUS_APPLICATION_VOIP, &error);
+        if (encoder != nullptr) {
+            std::vector<uint8_t> packet(4000);
+            for (size_t offset = 0; (offset + (frames * channels)) <= samples.size(); offset += (frames * channels)) {
+                const opus_int32 length = opus_encode(encoder, &samples[offset], static_cast<int>(frames), packet.data(), static_cast<opus_int32>(packet.size()));
+                if (length <= 0) {
+                    packets.clear();
+                    break;
+                }
+                packets.emplace_back(packet.begin(), packet.begin() + length);
+            }
+            opus_encoder_destroy(encoder);
+        }
+    }
+#endif
+
+    bool Encode(const std::string& codec, const uint32_t rate, const uint8_t channels, const uint32_t packet, Packets& packets)
+    {
+        std::vector<int16_t> samples;
+        Synthesize(rate, channels, samples);
+
+        const uint32_t frames = (rate * packet) / 1000;
+        if (codec == "ima-adpcm") {
+            EncodeImaAdpcm(samples, frames, packets);
+        }
+#if defined(VOICE_DECODER_OPUS)
+        else if (codec == "opus") {
+            EncodeOpus(samples, rate, channels, frames, packets);
+        }
+#endif
+        return (packets.empty() == false);
+    }
+
+    void Convert(const uint32_t rate, const uint8_t channels, const uint32_t seconds, const uint32_t packet, ConversionReport& report)
+    {
+        std::vector<int16_t> input;
+        Synthesize(rate, channels, input);
+
+        const uint32_t frames = (rate * packet) / 1000;
+        Plugin::AudioConverter converter;
+        converter.Configure(rate, channels, OUTPUT_RATE, frames);
+        std::vector<int16_t> output(converter.MaxOutputSamples(frames));
+
+        // Read back, so the compiler can not leave the conversion out
+        volatile size_t produced = 0;
+        uint64_t consumed = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t second = 0; second < seconds; ++second) {
+            for (uint32_t offset = 0; (offset + frames) <= rate; offset += frames) {
+                produced = produced + converter.Process(&input[offset * channels], frames, output.data(), output.size());
+                consumed += frames;
+            }
+        }
+        const uint64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        report.Rate = rate;
+        report.Channels = channels;
+        report.PassThrough = converter.IsPassThrough();
+        // Whole packets only, so per second of the audio that went in
+        report.Cost = static_cast<uint32_t>((duration * rate) / consumed);
+    }
+
+    void Decode(Plugin::VoiceDecoder& decoder, const uint32_t rate, const uint8_t channels, const uint32_t seconds, const Packets& packets, DecoderReport& report)
+    {
+        std::vector<int16_t> output((((rate * MAX_FRAME_MS) / 1000) + 1) * channels);
+        size_t bytes = 0;
+        for (const auto& packet : packets) {
+            bytes += packet.size();
+        }
+
+        decoder.Reset();
+        uint64_t produced = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t second = 0; second < seconds; ++second) {
+            for (const auto& packet : packets) {
+                produced += decoder.Decode(packet.data(), static_cast<uint16_t>(packet.size()), output.data(), output.size());
+            }
+        }
+        const uint64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        report.Codec = decoder.Name();
+        report.Rate = rate;
+        report.Channels = channels;
+        report.Size = static_cast<uint32_t>(bytes / packets.size());
+        // The packets hold a little less than a second, the cost is of the audio that came out
+        report.Cost = static_cast<uint32_t>((produced > 0) ? ((duration * rate * channels) / produced) : 0);
+    }
+
+    void Usage(const char* name)
+    {
+        fprintf(stderr,
+            "Usage: %s [-s <seconds>] [-p <packet>] [-o <report>]\n"
+            "  -s  Seconds of audio per run, %u when not given\n"
+            "  -p  Milliseconds of audio per packet, %u when not given\n"
+            "  -o  File to write the report to, stdout when not given\n",
+            name, DEFAULT_SECONDS, DEFAULT_PACKET);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    uint32_t seconds = DEFAULT_SECONDS;
+    uint32_t packet = DEFAULT_PACKET;
+    std::string reportPath;
+
+    int option;
+    while ((option = ::getopt(argc, argv, "s:p:o:h")) != -1) {
+        switch (option) {
+        case 's':
+            seconds = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'p':
+            packet = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'o':
+            reportPath = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((seconds == 0) || (packet == 0) || (packet > MAX_FRAME_MS)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    Report report;
+    report.Seconds = seconds;
+    report.Packet = packet;
+
+    for (const uint32_t rate : RATES) {
+        for (uint8_t channels = 1; channels <= MAX_CHANNELS; ++channels) {
+            Convert(rate, channels, seconds, packet, report.Conversions.Add());
+        }
+    }
+
+    static const char* const CODECS[] = { "ima-adpcm", "opus" };
+    for (const char* codec : CODECS) {
+        std::unique_ptr<Plugin::VoiceDecoder> decoder = Plugin::VoiceDecoder::Create(codec);
+        if (!decoder) {
+            fprintf(stderr, "%s is not compiled in, skipping it\n", codec);
+            continue;
+        }
+        for (const uint32_t rate : RATES) {
+            for (uint8_t channels = 1; channels <= MAX_CHANNELS; ++channels) {
+                Packets packets;
+                if ((decoder->Configure(rate, channels) == true) && (Encode(codec, rate, channels, packet, packets) == true)) {
+                    Decode(*decoder, rate, channels, seconds, packets, report.Decoders.Add());
+                }
+            }
+        }
+    }
+
+    string output;
+    report.ToString(output);
+    if (reportPath.empty() == true) {
+        printf("%s\n", output.c_str());
+    } else {
+        std::ofstream file(reportPath);
+        file << output << std::endl;
+    }
+
+    Core::Singleton::Dispose();
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+# If not stated otherwise in this file or this component's license file the
+# following copyright and licenses apply:
+#
+# Copyright 2020 RDK Management
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# - Try to find  Opus
+# Once done this will define
+#  OPUS_FOUND - System has Opus
+#  OPUS_INCLUDES - The Opus include directories
+#  OPUS_LIBRARIES - The libraries needed to use Opus
+
+find_path(OPUS_INCLUDES opus/opus.h)
+find_library(OPUS_LIBRARIES opus)
+
+find_package_handle_standard_args(OPUS DEFAULT_MSG
+        OPUS_INCLUDES
+        OPUS_LIBRARIES)
+mark_as_advanced(OPUS_FOUND OPUS_INCLUDES OPUS_LIBRARIES)